@@ -0,0 +1,33 @@
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include <stdint.h>
+
+// stackless coroutines, protothread style: a long operation is written as one function that
+// returns at every yield and jumps back to it on the next call, through a switch on the line
+// it stopped at, so it costs one resume point of SRAM instead of a stack
+// the function returns bool: false while it is still running, true once it is done
+// locals don't survive a yield, anything the operation needs across one goes in a global
+// no two yields on the same line, and no switch of its own around a yield
+
+// where a coroutine resumes: 0 = start from the top, CO_DONE = finished, otherwise a line
+typedef uint16_t coPoint;
+#define CO_DONE 0xFFFF
+
+#define CO_BEGIN(co) switch (co) { case CO_DONE: return true; case 0:
+
+// finished, every call after this returns true until the coroutine is restarted with co = 0
+#define CO_END(co) } (co) = CO_DONE; return true
+
+// gives up the tick, the next call carries on after it
+#define CO_YIELD(co) do { (co) = __LINE__; return false; case __LINE__:; } while (0)
+
+// gives up the tick until cond holds, checked straight away and again on every call
+#define CO_WAIT_UNTIL(co, cond) do { (co) = __LINE__; case __LINE__: if (!(cond)) { return false; } } while (0)
+
+// gives up the tick and resumes on the first call at least ms later, using sysTime
+// wake is the uint16_t the wake-up time is kept in
+#define CO_SLEEP(co, wake, ms) do { (wake) = sysTime + (ms); (co) = __LINE__; return false; \
+    case __LINE__: if ((int16_t)(sysTime - (wake)) < 0) { return false; } } while (0)
+
+#endif /* COROUTINE_H */
@@ -0,0 +1,106 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <avr/pgmspace.h>
+#include <stdint.h>
+
+// display driver policies: everything the renderer needs to know about a panel, picked at
+// compile time, so a driver costs nothing at runtime and its fast paths are constants the
+// compiler folds away on the other panels
+// a policy gives
+//   coord: type of a screen coordinate
+//   width, height: visible pixels, x0, y0: where they start in the controller memory
+//   initSequence, initLength: init entries, see lcdInit()
+//   spi2x: the panel keeps up with the SPI clock at F_CPU / 2 instead of F_CPU / 4
+//   burst: pixel data goes out with CS held low from RAMWR on, not toggled per byte
+//   partialColumns: the controller's lines run along screen x, so PTLAR takes a range of
+//     columns instead of rows
+// needs LCD_COLMOD from graphics.h
+
+// #define LCD_ILI9341 // 320 x 240 ILI9341 instead of the 128 x 128 ST7735
+
+// commands both controllers share
+#define SWRESET 0x01
+#define SLPOUT 0x11
+#define PTLON 0x12 // partial mode, only the lines PTLAR gives are driven
+#define NORON 0x13 // back to normal mode, every line driven
+#define DISPON 0x29
+#define CASET 0x2A
+#define RASET 0x2B
+#define RAMWR 0x2C
+#define MADCTL 0x36
+#define PTLAR 0x30
+#define IDMOFF 0x38
+#define IDMON 0x39 // idle mode, 8 colors: the top bit of each channel
+#define COLMOD 0x3A
+
+// ILI9341 panel settings
+#define ILI_FRMCTR1 0xB1
+#define ILI_PWCTR1 0xC0
+#define ILI_PWCTR2 0xC1
+#define ILI_VMCTR1 0xC5
+#define ILI_VMCTR2 0xC7
+
+// init sequences, each entry: command, number of data bytes, data bytes, delay (ms) before the next entry
+const uint8_t PROGMEM st7735Init[] = {
+    SWRESET, 0, 150,
+    SLPOUT, 0, 200,
+    COLMOD, 1, LCD_COLMOD, 10, // set color mode (16 or 12-bit)
+    DISPON, 0, 200,
+    MADCTL, 1, 0xC8, 0, // set memory data access control
+};
+
+const uint8_t PROGMEM ili9341Init[] = {
+    SWRESET, 0, 150,
+    ILI_PWCTR1, 1, 0x23, 0, // GVDD 4.6 V
+    ILI_PWCTR2, 1, 0x10, 0,
+    ILI_VMCTR1, 2, 0x3E, 0x28, 0, // VCOMH 4.25 V, VCOML -1.5 V
+    ILI_VMCTR2, 1, 0x86, 0,
+    ILI_FRMCTR1, 2, 0x00, 0x18, 0, // 79 Hz
+    SLPOUT, 0, 120,
+    COLMOD, 1, 0x55, 10, // 16-bit, it has no 12-bit mode over SPI
+    MADCTL, 1, 0x28, 0, // rows and columns swapped for landscape, BGR
+    DISPON, 0, 120,
+};
+
+// ST7735 with the 128 x 128 panel, 132 x 162 controller memory
+struct ST7735 {
+    typedef uint8_t coord;
+    static const uint16_t width = 128;
+    static const uint16_t height = 128;
+    static const uint8_t x0 = 2;
+    static const uint8_t y0 = 3;
+    static const uint8_t initLength = sizeof(st7735Init);
+    static const bool spi2x = false;
+    static const bool burst = false;
+    static const bool partialColumns = false;
+    static const uint8_t *initSequence() { return st7735Init; }
+};
+
+// ILI9341 with the 320 x 240 panel in landscape, the memory is the panel
+struct ILI9341 {
+    typedef uint16_t coord;
+    static const uint16_t width = 320;
+    static const uint16_t height = 240;
+    static const uint8_t x0 = 0;
+    static const uint8_t y0 = 0;
+    static const uint8_t initLength = sizeof(ili9341Init);
+    static const bool spi2x = true;
+    static const bool burst = true;
+    static const bool partialColumns = true; // MV swaps them
+    static const uint8_t *initSequence() { return ili9341Init; }
+};
+
+#ifdef LCD_ILI9341
+#ifdef COLOR_12BIT
+#error "the ILI9341 has no 12-bit mode over SPI, COLOR_12BIT is ST7735 only"
+#endif
+typedef ILI9341 Display;
+#else
+typedef ST7735 Display;
+#endif
+
+// screen coordinates, a byte where the panel is small enough
+typedef Display::coord lcdCoord;
+
+#endif /* DISPLAY_H */
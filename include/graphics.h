@@ -11,359 +11,388 @@
 #define ORANGE 0xFD20
 #define PURPLE 0xF81F
 
-
-// not revealed, not selected
-const uint16_t PROGMEM emptyUnrevealedGrid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-};
-
-// not revealed, but selected
-const uint16_t PROGMEM emptyUnrevealedSelectedGrid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, GREEN, BLACK, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
+// 5 x 7 digit font for the HUD, one byte per column, bit 0 is the top row
+const uint8_t PROGMEM hudFont[10][5] = {
+    { 0x3E, 0x51, 0x49, 0x45, 0x3E }, // 0
+    { 0x00, 0x42, 0x7F, 0x40, 0x00 }, // 1
+    { 0x42, 0x61, 0x51, 0x49, 0x46 }, // 2
+    { 0x21, 0x41, 0x45, 0x4B, 0x31 }, // 3
+    { 0x18, 0x14, 0x12, 0x7F, 0x10 }, // 4
+    { 0x27, 0x45, 0x45, 0x45, 0x39 }, // 5
+    { 0x3C, 0x4A, 0x49, 0x49, 0x30 }, // 6
+    { 0x01, 0x71, 0x09, 0x05, 0x03 }, // 7
+    { 0x36, 0x49, 0x49, 0x49, 0x36 }, // 8
+    { 0x06, 0x49, 0x49, 0x29, 0x1E }, // 9
 };
 
-// revealed empty grid, not selected
-const uint16_t PROGMEM emptyRevealedGrid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
+// pixel format, COLOR_12BIT packs two pixels into 3 bytes instead of 4
+// #define COLOR_12BIT
+#ifdef COLOR_12BIT
+#define LCD_COLMOD 0x03
+#else
+#define LCD_COLMOD 0x05
+#endif
+
+// convert a 16-bit (5-6-5) color to 12-bit (4-4-4) by dropping the low bits of each channel
+#define COLOR_TO_444(c) (((((c) >> 12) & 0x0F) << 8) | ((((c) >> 7) & 0x0F) << 4) | (((c) >> 1) & 0x0F))
+
+// sprite palette, sprites store a 4-bit index into it per pixel
+enum {
+    PAL_BLACK,
+    PAL_BLUE,
+    PAL_RED,
+    PAL_GREEN,
+    PAL_YELLOW,
+    PAL_BROWN,
+    PAL_ORANGE,
+    PAL_PURPLE,
+    PALETTE_SIZE
 };
 
-// revealed empty grid, but selected 
-const uint16_t PROGMEM emptyRevealedSelectedGrid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
+// each entry is already split into the bytes the LCD is sent, so a pixel pair is
+// just table reads: 16-bit sends a0 a1 b0 b1, 12-bit sends a0 (a1 | b2) b3
+#ifdef COLOR_12BIT
+#define PALETTE_ENTRY(c) { COLOR_TO_444(c) >> 4, (COLOR_TO_444(c) & 0x0F) << 4, COLOR_TO_444(c) >> 8, COLOR_TO_444(c) & 0xFF }
+#else
+#define PALETTE_ENTRY(c) { (c) >> 8, (c) & 0xFF, 0, 0 }
+#endif
+
+const uint8_t PROGMEM lcdPalette[PALETTE_SIZE][4] = {
+    PALETTE_ENTRY(BLACK),
+    PALETTE_ENTRY(BLUE),
+    PALETTE_ENTRY(RED),
+    PALETTE_ENTRY(GREEN),
+    PALETTE_ENTRY(YELLOW),
+    PALETTE_ENTRY(BROWN),
+    PALETTE_ENTRY(ORANGE),
+    PALETTE_ENTRY(PURPLE),
 };
 
-// revealed, 1 mine in proximity, not selected
-const uint16_t PROGMEM number1Grid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
+// the same colors as plain 5-6-5 values, for fills and screenshots
+const uint16_t PROGMEM paletteColors[PALETTE_SIZE] = {
+    BLACK, BLUE, RED, GREEN, YELLOW, BROWN, ORANGE, PURPLE,
 };
 
-// revealed, 1 mine in proximity, but selected
-const uint16_t PROGMEM number1SelectedGrid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BLACK, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-};
-
-// revealed, 2 mines in proximity, not selected
-const uint16_t PROGMEM number2Grid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, PURPLE, PURPLE, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, PURPLE, PURPLE, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, PURPLE, PURPLE, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, PURPLE, PURPLE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, PURPLE, PURPLE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, PURPLE, PURPLE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BROWN, BLACK },
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, PURPLE, BROWN, BROWN, BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-};
-
-// revealed, 2 mines in proximity, but selected
-const uint16_t PROGMEM number2SelectedGrid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, PURPLE, PURPLE, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, PURPLE, PURPLE, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, PURPLE, PURPLE, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, PURPLE, PURPLE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, PURPLE, PURPLE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, PURPLE, PURPLE, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, PURPLE, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
+// 16 x 16 sprites are drawn as ASCII art, one character per pixel:
+//   . black  B blue  R red  G green  Y yellow  N brown  O orange  P purple
+// and packed at compile time into 4 bits per pixel, two pixels per byte with the
+// left one in the high nibble (128 bytes instead of 512 for 16-bit colors)
+// every sprite fits the palette, and unlike RLE this keeps random access for the
+// cropped and delta draws
+// each zoom level has its own set of every sprite, scaled down from the same art
+#define SPRITE_ART_SIZE 16
+#define SPRITE_ART(art) \
+    static_assert(sizeof(art) == SPRITE_ART_SIZE * SPRITE_ART_SIZE + 1, #art " must be 16 x 16")
+
+// sprites by id, a set stores them in this order
+enum {
+    SPRITE_EMPTY_UNREVEALED,
+    SPRITE_EMPTY_UNREVEALED_SELECTED,
+    SPRITE_EMPTY_REVEALED,
+    SPRITE_EMPTY_REVEALED_SELECTED,
+    SPRITE_NUMBER_1,
+    SPRITE_NUMBER_1_SELECTED,
+    SPRITE_NUMBER_2,
+    SPRITE_NUMBER_2_SELECTED,
+    SPRITE_NUMBER_3,
+    SPRITE_NUMBER_3_SELECTED,
+    SPRITE_FLAG,
+    SPRITE_FLAG_SELECTED,
+    SPRITE_EXPLOSION_1PX,
+    SPRITE_EXPLOSION_2PX,
+    SPRITE_COUNT
 };
-
-// revealed, 3 mines in proximity, not selected
-const uint16_t PROGMEM number3Grid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-};
-
-
-// revealed, 2 mines in proximity, but selected
-const uint16_t PROGMEM number3SelectedGrid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLUE, BLUE, BROWN, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BROWN, BROWN, BROWN, BLUE, BLUE, BLUE, BLUE, BLUE, BLUE, BROWN, BROWN, BROWN, BLACK, BLACK },
-
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
+#define SPRITE_NONE 0xFF // nothing drawn
+
+// not revealed
+constexpr char emptyUnrevealedArt[] =
+    "................"
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    ".GGGGGGGGGGGGGG."
+    "................";
+SPRITE_ART(emptyUnrevealedArt);
+
+// revealed, no mines in proximity
+constexpr char emptyRevealedArt[] =
+    "................"
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNNNNNNNN."
+    "................";
+SPRITE_ART(emptyRevealedArt);
+
+// revealed, 1 mine in proximity
+constexpr char number1Art[] =
+    "................"
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNBBBNNNNNN."
+    ".NNNNNBBBNNNNNN."
+    ".NNNNNNBBNNNNNN."
+    ".NNNNNNBBNNNNNN."
+    ".NNNNNNBBNNNNNN."
+    ".NNNNNNBBNNNNNN."
+    ".NNNNNNBBNNNNNN."
+    ".NNNNNNBBNNNNNN."
+    ".NNNNNNBBNNNNNN."
+    ".NNNNNNBBNNNNNN."
+    ".NNNNNNBBNNNNNN."
+    ".NNNNBBBBBBNNNN."
+    ".NNNNNNNNNNNNNN."
+    "................";
+SPRITE_ART(number1Art);
+
+// revealed, 2 mines in proximity
+constexpr char number2Art[] =
+    "................"
+    ".NNNNNNNNNNNNNN."
+    ".NNPPPPPPPPPPNN."
+    ".NNPPPPPPPPPPNN."
+    ".NNNNNNNNNNPPNN."
+    ".NNNNNNNNNNPPNN."
+    ".NNNNNNNNNNPPNN."
+    ".NNPPPPPPPPPPNN."
+    ".NNPPPPPPPPPPNN."
+    ".NNPPNNNNNNNNNN."
+    ".NNPPNNNNNNNNNN."
+    ".NNPPNNNNNNNNNN."
+    ".NNPPPPPPPPPPNN."
+    ".NNPPPPPPPPPPNN."
+    ".NNNNNNNNNNNNNN."
+    "................";
+SPRITE_ART(number2Art);
+
+// revealed, 3 or more mines in proximity
+constexpr char number3Art[] =
+    "................"
+    ".NNNNNNNNNNNNNN."
+    ".NNNNBBBBBBNNNN."
+    ".NNNNBBBBBBNNNN."
+    ".NNNNNNNBBNNNNN."
+    ".NNNNNNNBBNNNNN."
+    ".NNNNNNNBBNNNNN."
+    ".NNNNBBBBBNNNNN."
+    ".NNNNBBBBBNNNNN."
+    ".NNNNNNNBBNNNNN."
+    ".NNNNNNNBBNNNNN."
+    ".NNNNNNNBBNNNNN."
+    ".NNNNBBBBBBNNNN."
+    ".NNNNBBBBBBNNNN."
+    ".NNNNNNNNNNNNNN."
+    "................";
+SPRITE_ART(number3Art);
+
+// flagged
+constexpr char flagArt[] =
+    "................"
+    ".NNNNNNNNNNNNNN."
+    ".NNNNNNNR.NNNNN."
+    ".NNNNNNRR.NNNNN."
+    ".NNNNNRRR.NNNNN."
+    ".NNNRRRRR.NNNNN."
+    ".NNNNRRRR.NNNNN."
+    ".NNNNNRRR.NNNNN."
+    ".NNNNNNRR.NNNNN."
+    ".NNNNNNNR.NNNNN."
+    ".NNNNNNNN.NNNNN."
+    ".NNNNNNNN.NNNNN."
+    ".NNNNNNNN.NNNNN."
+    ".NNNNNNNN.NNNNN."
+    ".NNNNNNNN.NNNNN."
+    "................";
+SPRITE_ART(flagArt);
+
+// mine going off, two sizes alternated by explosionAnim
+constexpr char explosionMine1pxArt[] =
+    "................"
+    ".RRROOOYYOOORRR."
+    ".RROOOYYYOOOORR."
+    ".ROOOYYYYYOOOOR."
+    ".OOOYYYYYYYOOOO."
+    ".OOYYYYYYYYYOOO."
+    ".OYYYYYYYYYYYOO."
+    ".YYYYYYYYYYYYYO."
+    ".YYYYYYYYYYYYYY."
+    ".OYYYYYYYYYYYOO."
+    ".OOYYYYYYYYYOOO."
+    ".OOOYYYYYYYOOOO."
+    ".ROOOYYYYYOOOOR."
+    ".RROOOYYYOOOORR."
+    ".RRROOOYYOOORRR."
+    "................";
+SPRITE_ART(explosionMine1pxArt);
+
+constexpr char explosionMine2pxArt[] =
+    "................"
+    "..RRROOOYYOOORR."
+    "..ROOOYYYOOOORR."
+    "..OOOYYYYYOOOOO."
+    "..OOYYYYYYYYOOO."
+    "..OYYYYYYYYYYOO."
+    "..YYYYYYYYYYYYO."
+    "..YYYYYYYYYYYYY."
+    "..YYYYYYYYYYYYY."
+    "..YYYYYYYYYYYYO."
+    "..OYYYYYYYYYYOO."
+    "..OOYYYYYYYYOOO."
+    "..OOOYYYYYOOOOO."
+    "..ROOOYYYOOOORR."
+    "..RRROOOYYOOORR."
+    "................";
+SPRITE_ART(explosionMine2pxArt);
+
+// packing and scaling, all at compile time
+// not defined on purpose: reaching it at compile time means the art has a character
+// that isn't in the palette, and the build fails on the sprite using it
+uint8_t spriteBadCharacter(char c);
+
+constexpr uint8_t spriteColor(char c) {
+    return c == '.' ? PAL_BLACK :
+           c == 'B' ? PAL_BLUE :
+           c == 'R' ? PAL_RED :
+           c == 'G' ? PAL_GREEN :
+           c == 'Y' ? PAL_YELLOW :
+           c == 'N' ? PAL_BROWN :
+           c == 'O' ? PAL_ORANGE :
+           c == 'P' ? PAL_PURPLE :
+           spriteBadCharacter(c);
+}
+
+// art and selected look of each sprite id
+constexpr const char *spriteArts[SPRITE_COUNT] = {
+    emptyUnrevealedArt, emptyUnrevealedArt, emptyRevealedArt, emptyRevealedArt,
+    number1Art, number1Art, number2Art, number2Art, number3Art, number3Art,
+    flagArt, flagArt, explosionMine1pxArt, explosionMine2pxArt,
 };
-
-
-// revealed, 3 mines in proximity, not selected
-const uint16_t PROGMEM flagGrid[16][16] = {
-    // TODO: Add number 3 graphic data
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, RED, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, RED, RED, RED, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, RED, RED, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, RED, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
+constexpr bool spriteSelected[SPRITE_COUNT] = {
+    false, true, false, true, false, true, false, true, false, true, false, true, false, false,
 };
 
-// revealed, 3 mines in proximity, not selected
-const uint16_t PROGMEM flagSelectedGrid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, RED, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, RED, RED, RED, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, RED, RED, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, RED, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-    
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, RED, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, RED, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK, BROWN, BROWN, BROWN, BROWN, BROWN, BLACK },
-
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
+// a pixel of an S x S sprite stands for a block of art pixels: the 1 px border keeps
+// the art's border, the inside is spread evenly over the art's 14 x 14 inside
+constexpr unsigned spriteFrom(unsigned size, unsigned i) {
+    return i == 0 ? 0 :
+           i == size - 1 ? SPRITE_ART_SIZE - 1 :
+           1 + (i - 1) * (SPRITE_ART_SIZE - 2) / (size - 2);
+}
+
+constexpr unsigned spriteTo(unsigned size, unsigned i) {
+    return i == size - 1 ? SPRITE_ART_SIZE : spriteFrom(size, i + 1);
+}
+
+// art pixels of a color among the first n of the block at (r0, c0), w wide
+constexpr unsigned spriteCount(const char *art, uint8_t color, unsigned r0, unsigned c0, unsigned w, unsigned n) {
+    return n == 0 ? 0 :
+           (spriteColor(art[(r0 + (n - 1) / w) * SPRITE_ART_SIZE + c0 + (n - 1) % w]) == color) +
+           spriteCount(art, color, r0, c0, w, n - 1);
+}
+
+// the tile's fill color counts once and anything drawn on it three times,
+// so thin digit strokes survive the scaling instead of being outvoted
+constexpr unsigned spriteWeight(const char *art, uint8_t color, unsigned r0, unsigned c0, unsigned w, unsigned n) {
+    return spriteCount(art, color, r0, c0, w, n) *
+           (color == spriteColor(art[SPRITE_ART_SIZE + 1]) ? 1 : 3);
+}
+
+// the heaviest color of a block, trying palette entries from color up
+constexpr uint8_t spriteBest(const char *art, unsigned r0, unsigned c0, unsigned w, unsigned n,
+                             uint8_t color, uint8_t best) {
+    return color == PALETTE_SIZE ? best :
+           spriteBest(art, r0, c0, w, n, color + 1,
+                      spriteWeight(art, color, r0, c0, w, n) > spriteWeight(art, best, r0, c0, w, n) ? color : best);
+}
+
+// the selected look is the same tile shrunk by a black ring, 2 px wide, 1 px on 8 x 8 sprites
+constexpr bool spriteInRing(unsigned size, unsigned r, unsigned c) {
+    return r < (size >= 12 ? 2u : 1u) || r >= size - (size >= 12 ? 2u : 1u) ||
+           c < (size >= 12 ? 2u : 1u) || c >= size - (size >= 12 ? 2u : 1u);
+}
+
+constexpr uint8_t spritePixel(unsigned id, unsigned size, unsigned i) {
+    return (spriteSelected[id] && spriteInRing(size, i / size, i % size)) ? PAL_BLACK :
+           spriteBest(spriteArts[id], spriteFrom(size, i / size), spriteFrom(size, i % size),
+                      spriteTo(size, i % size) - spriteFrom(size, i % size),
+                      (spriteTo(size, i / size) - spriteFrom(size, i / size)) *
+                      (spriteTo(size, i % size) - spriteFrom(size, i % size)),
+                      0, 0);
+}
+
+constexpr uint8_t spritePair(unsigned id, unsigned size, unsigned k) {
+    return (spritePixel(id, size, 2 * k) << 4) | spritePixel(id, size, 2 * k + 1);
+}
+
+// 0, 1, ..., N - 1 as a template parameter pack
+template <unsigned... I> struct SpriteIndices {};
+template <unsigned N, unsigned... I> struct SpriteRange : SpriteRange<N - 1, N - 1, I...> {};
+template <unsigned... I> struct SpriteRange<0, I...> { typedef SpriteIndices<I...> type; };
+
+// a size x size sprite, and every sprite at that size in SPRITE_* order
+template <unsigned Size> struct sprite {
+    uint8_t px[Size * Size / 2];
 };
 
-const uint16_t PROGMEM explosionMine1pxGrid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, RED,   RED,   RED,   ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,RED,   RED,   RED,   BLACK },
-    { BLACK, RED,   RED,   ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,ORANGE,RED,   RED,   BLACK },
-    { BLACK, RED,   ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,ORANGE,RED,   BLACK },
-    { BLACK, ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,ORANGE,BLACK },
-    { BLACK, ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,BLACK },
-    { BLACK, ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,BLACK },
-    { BLACK, YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,BLACK },
-    { BLACK, YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,BLACK },
-    { BLACK, ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,BLACK },
-    { BLACK, ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,BLACK },
-    { BLACK, ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,ORANGE,BLACK },
-    { BLACK, RED,   ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,ORANGE,RED,   BLACK },
-    { BLACK, RED,   RED,   ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,ORANGE,RED,   RED,   BLACK },
-    { BLACK, RED,   RED,   RED,   ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,RED,   RED,   RED,   BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK }
+template <unsigned Size> struct spriteSet {
+    sprite<Size> sprites[SPRITE_COUNT];
 };
 
-const uint16_t PROGMEM explosionMine2pxGrid[16][16] = {
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK },
-    { BLACK, BLACK, RED,   RED,   RED,   ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,RED,   RED,   BLACK },
-    { BLACK, BLACK, RED,   ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,ORANGE,RED,   RED,   BLACK },
-    { BLACK, BLACK, ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,ORANGE,ORANGE,BLACK },
-    { BLACK, BLACK, ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,BLACK },
-    { BLACK, BLACK, ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,BLACK },
-    { BLACK, BLACK, YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,BLACK },
-    { BLACK, BLACK, YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,BLACK },
-    { BLACK, BLACK, YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,BLACK },
-    { BLACK, BLACK, YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,BLACK },
-    { BLACK, BLACK, ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,BLACK },
-    { BLACK, BLACK, ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,BLACK },
-    { BLACK, BLACK, ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,ORANGE,ORANGE,BLACK },
-    { BLACK, BLACK, RED,   ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,ORANGE,RED,   RED,   BLACK },
-    { BLACK, BLACK, RED,   RED,   RED,   ORANGE,ORANGE,ORANGE,YELLOW,YELLOW,ORANGE,ORANGE,ORANGE,RED,   RED,   BLACK },
-    { BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK, BLACK }
-};
\ No newline at end of file
+template <unsigned Size, unsigned... I>
+constexpr sprite<Size> spritePack(unsigned id, SpriteIndices<I...>) {
+    return { { spritePair(id, Size, I)... } };
+}
+
+template <unsigned Size, unsigned... Id>
+constexpr spriteSet<Size> spriteSetPack(SpriteIndices<Id...>) {
+    return { { spritePack<Size>(Id, typename SpriteRange<Size * Size / 2>::type())... } };
+}
+
+// defines the PROGMEM set for a zoom level, constexpr so the packing can't end up running at boot
+#define SPRITE_SET(name, size) \
+    static_assert((size) % 2 == 0 && (size) >= 8 && (size) <= SPRITE_ART_SIZE, "sprite sizes are even, 8 to 16"); \
+    constexpr spriteSet<size> PROGMEM name = spriteSetPack<size>(SpriteRange<SPRITE_COUNT>::type())
+
+SPRITE_SET(sprites16, 16);
+SPRITE_SET(sprites12, 12);
+SPRITE_SET(sprites8, 8);
+
+// tile animations, each frame is a sprite id, sent as a delta against the one before it
+typedef struct _animation {
+    uint8_t numFrames;
+    uint8_t frameTime; // ms per frame
+    uint8_t frames[5];
+} animation;
+
+// mine going off, alternates between the two explosion sizes
+const animation PROGMEM explosionAnim = { 5, 80, {
+    SPRITE_EXPLOSION_1PX,
+    SPRITE_EXPLOSION_2PX,
+    SPRITE_EXPLOSION_1PX,
+    SPRITE_EXPLOSION_2PX,
+    SPRITE_EXPLOSION_1PX,
+} };
+
+// highlight that sweeps across the board on a win
+const animation PROGMEM sweepAnim = { 1, 100, {
+    SPRITE_EMPTY_REVEALED_SELECTED,
+} };
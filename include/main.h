@@ -4,6 +4,10 @@
 #include "serialATmega.h"
 #include "timerISR.h"
 #include "graphics.h"
+#include "display.h"
+#include "replay.h"
+#include "sound.h"
+#include "coroutine.h"
 #include <avr/pgmspace.h>
 #include <stdint.h>
 
@@ -17,28 +21,107 @@ typedef enum {
     FLAG = 5
 } CellStatus;
 
-// structs
-// 16 * 16 graphic cell
-typedef struct _graphic {
-    uint16_t graphicGrid[16][16];
-} graphic;
+// a cell packed into a byte: its status (mine count or mine) in the low nibble plus state bits
+// the low 7 bits are also what the renderer draws from, see cellSprites
+#define CELL_STATUS 0x0F // CellStatus
+#define CELL_REVEALED 0x10
+#define CELL_FLAGGED 0x20
+#define CELL_SELECTED 0x40
+#define CELL_ANIMATING 0x80 // an animation owns the tile on screen
+#define CELL_LOOKS 0x80 // look bytes the sprite table covers
 
-typedef struct _cell {
-    CellStatus status;
-    bool revealed = false;
-    bool flagged = false;
-    bool selected = false;
-    const uint16_t *gfx;
-} cell;
+// sprite id for every look byte, worked out at compile time so picking a tile never branches
+constexpr uint8_t lookRevealed(uint8_t status, bool selected) {
+    return status == EMPTY ? (selected ? SPRITE_EMPTY_REVEALED_SELECTED : SPRITE_EMPTY_REVEALED) :
+           status == NUMBER_1 ? (selected ? SPRITE_NUMBER_1_SELECTED : SPRITE_NUMBER_1) :
+           status == NUMBER_2 ? (selected ? SPRITE_NUMBER_2_SELECTED : SPRITE_NUMBER_2) :
+           status == NUMBER_3 ? (selected ? SPRITE_NUMBER_3_SELECTED : SPRITE_NUMBER_3) :
+           status == EXPLODED_MINE ? SPRITE_EXPLOSION_1PX :
+           (status == FLAG && selected) ? SPRITE_FLAG_SELECTED :
+           SPRITE_EMPTY_REVEALED;
+}
+
+// a mine flagged before the loss reveals them all keeps its flag while selected
+constexpr uint8_t lookSprite(uint8_t look) {
+    return (look & CELL_REVEALED) ?
+               (((look & CELL_SELECTED) && (look & CELL_FLAGGED)) ? SPRITE_FLAG :
+                lookRevealed(look & CELL_STATUS, look & CELL_SELECTED)) :
+           (look & CELL_FLAGGED) ? ((look & CELL_SELECTED) ? SPRITE_FLAG_SELECTED : SPRITE_FLAG) :
+           (look & CELL_SELECTED) ? SPRITE_EMPTY_UNREVEALED_SELECTED : SPRITE_EMPTY_UNREVEALED;
+}
+
+typedef struct _cellSpriteTable {
+    uint8_t id[CELL_LOOKS];
+} cellSpriteTable;
+
+template <unsigned... I>
+constexpr cellSpriteTable cellSpritesPack(SpriteIndices<I...>) {
+    return { { lookSprite(I)... } };
+}
+
+constexpr cellSpriteTable PROGMEM cellSprites = cellSpritesPack(SpriteRange<CELL_LOOKS>::type());
+
+// largest board, at the smallest zoom level, boardRows and boardCols give the current one
+#define MAX_ROWS 16
+#define MAX_COLS 16
+
+// a batch of game actions applied as one board write, see txnBegin()
+typedef struct _boardTxn {
+    uint16_t changed[MAX_ROWS]; // bit j of changed[i] = cell (i, j) changed
+    uint8_t events; // state transitions, see TXN_LOST etc.
+} boardTxn;
+
+// an input event, see EVENT_MOVE etc.
+typedef struct _gameEvent {
+    uint8_t type;
+    uint8_t arg;
+} gameEvent;
+
+// a zoom level: sprite size, the board that fits on screen at that size, and its sprites
+typedef struct _zoomLevel {
+    uint8_t size;
+    uint8_t rows;
+    uint8_t cols;
+    uint8_t mines;
+    const uint8_t *sprites; // PROGMEM spriteSet of that size
+} zoomLevel;
+
+// a running tile animation
+typedef struct _animSlot {
+    const animation *anim; // PROGMEM, NULL = free slot
+    uint8_t x;
+    uint8_t y;
+    uint8_t frame; // next frame to draw
+    uint16_t nextTime; // when to draw it (sysTime)
+} animSlot;
 
 // function defines
 void gpioInit();
-void lcdInit();
+bool lcdInit();
 void initGrid();
-void drawSquare(uint8_t x0, uint8_t y0, const uint16_t *gfx);
+bool boardReady();
+void placeMines();
+void countMines();
+void compute3BV();
+void drawSquare(lcdCoord x0, lcdCoord y0, uint8_t id);
 void drawScreen();
-uint16_t readGraphicPixel(const uint16_t *gfx, uint8_t row, uint8_t col);
-void fillRect(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t color);
+uint8_t cellSprite(uint8_t look);
+uint8_t drawnSprite(uint8_t look);
+uint8_t readGraphicPixel(uint8_t id, uint8_t row, uint8_t col);
+void fillStart(lcdCoord x0, lcdCoord y0, lcdCoord x1, lcdCoord y1, uint16_t color);
+void fillScreen(uint8_t color);
+bool fillStep();
+void shotStart();
+bool shotStep();
+bool dumpStep();
+void drawHud();
+void revealCell(uint8_t x, uint8_t y);
+uint16_t chordCell(uint8_t x, uint8_t y);
+bool animStart(const animation *anim, uint8_t x, uint8_t y, uint16_t delay);
+void animCascade(uint8_t x, uint8_t y);
+void animStep();
+void linkSend(uint8_t op, uint8_t arg, uint16_t payload);
+void linkPoll();
 
 // pin defines
 // Port B
@@ -60,35 +143,282 @@ void fillRect(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t color);
 // #define RESET_BUTTON PD3
 // #define PLAYER_BUTTON PD4
 #define SELECT_BUTTON PC2
-#define BUZZER PD6
+// BUZZER PD6, in sound.h
+
+// head-to-head mode: two units play the same board and swap progress over the UART
+// #define VERSUS_MODE
+#define LINK_BAUD 38400UL
+
+// command interface: a test rig or bot drives the game over the UART with batched binary
+// commands, framed like the versus link (see LINK_HEADER), and applied as input events
+// #define COMMAND_MODE
+#define COMMAND_BAUD 250000UL
+
+// copies every byte sent to the LCD onto the UART, tools/st7735_decode.py rebuilds the frames
+// from it and reports the traffic of each one, waits for room on the UART so drawing slows down
+// stream: 0xFF c = command c, 0xFE = end of an LCD tick, 0xFD x = data byte x (x >= 0xFD),
+// any other byte = data, LCD_STATS and TASK_STATS don't build with it, their prints would land in it
+// #define LCD_CAPTURE
+#define LCD_CAPTURE_BAUD 1000000UL
+#define CAPTURE_ESCAPE 0xFD
+#define CAPTURE_FRAME 0xFE
+#define CAPTURE_COMMAND 0xFF
+
+#if (defined(LCD_CAPTURE) + defined(VERSUS_MODE) + defined(COMMAND_MODE)) > 1
+#error "only one of LCD_CAPTURE, VERSUS_MODE and COMMAND_MODE can have the UART"
+#endif
+// after the modes, it's only built for them
+#include "uart.h"
+
+// debug prints over serial, they would corrupt the versus link, the capture or command replies
+#if !defined(VERSUS_MODE) && !defined(LCD_CAPTURE) && !defined(COMMAND_MODE)
+#define SERIAL_DEBUG
+#endif
+
+// counts bytes and windows sent to the LCD and reports them per frame over serial
+// #define LCD_STATS
+#if defined(LCD_STATS) && (defined(LCD_CAPTURE) || defined(VERSUS_MODE) || defined(COMMAND_MODE))
+#error "LCD_STATS prints with the blocking serial_println(), its bytes would land in the middle of what the UART mode sends"
+#endif
+
+// time LCD_Tick may spend on board cells per tick (us), cells left over are drawn on the next tick
+// a cell is only started while under budget, so a tick runs over by at most one cell draw
+#define LCD_BUDGET_US 8000
+
+// display power: once there has been no input for LCD_IDLE_MS and nothing is animating, the
+// panel goes to idle mode (8 colors) and partial mode (only the HUD and board lines driven),
+// and the renderer only draws what changes, the next input event brings normal mode back
+// in idle mode brown reads as black and orange as yellow, the board stays readable
+// 0 = always full power
+#define LCD_IDLE_MS 10000UL
+static_assert(LCD_IDLE_MS < 32768UL, "LCD_IDLE_MS is compared against the wrapping 16-bit sysTime");
+
+// dimension defines, from the display driver
+#define LCD_WIDTH (Display::width - 1)
+#define LCD_HEIGHT (Display::height - 1)
 
-// LCD command defines
-#define SWRESET 0x01
-#define CASET 0x2A
-#define RASET 0x2B
-#define RAMWR 0x2C
+// the board is also kept as bitmasks, one word per line of boardCols cells (bit j = cell j)
+// so generation and flood fill work on a whole line at a time
 
-// dimension defines
-#define LCD_WIDTH 127
-#define LCD_HEIGHT 127
+// first visible column and row of the panel, and the size of what it shows of its memory
+#define SCREEN_X0 Display::x0
+#define SCREEN_Y0 Display::y0
+#define SCREEN_WIDTH Display::width
+#define SCREEN_HEIGHT Display::height
 
-// rows and columns on the screen
-#define ROWS 8
-#define COLS 8
+// HUD strip right above the board
+#define HUD_HEIGHT 8
+#define HUD_DIGITS 3 // digits per counter
+#define HUD_GLYPH_WIDTH 6 // 5 px glyph + 1 px spacing
 
+// neighbouring cells share their 1 px border, so only the last size - 1 rows and columns of
+// each sprite are drawn, which frees the HUD strip above the board
+#define SPRITE_CROP 1
+
+// zoom levels, smaller sprites fit a bigger board and cost less to send
+// a level's board has to fit in MAX_ROWS x MAX_COLS, and under the HUD at (size - 1) px a cell
+// versus mode needs both units on the same level
+// #define ZOOM_DEFAULT 2
+#ifndef ZOOM_DEFAULT
+#define ZOOM_DEFAULT 0
+#endif
+#ifdef LCD_ILI9341
+// beginner and intermediate boards
+#define ZOOM_LEVELS 2
+constexpr zoomLevel PROGMEM zoomLevels[ZOOM_LEVELS] = {
+    { 16, 9, 9, 10, sprites16.sprites[0].px },
+    { 12, 16, 16, 40, sprites12.sprites[0].px },
+};
+#else
+#define ZOOM_LEVELS 3
+constexpr zoomLevel PROGMEM zoomLevels[ZOOM_LEVELS] = {
+    { 16, 8, 8, 7, sprites16.sprites[0].px },
+    { 12, 10, 10, 12, sprites12.sprites[0].px },
+    { 8, 16, 16, 30, sprites8.sprites[0].px },
+};
+#endif
+
+constexpr bool zoomFits(unsigned k) {
+    return k == ZOOM_LEVELS ||
+           (zoomLevels[k].rows <= MAX_ROWS && zoomLevels[k].cols <= MAX_COLS &&
+            zoomLevels[k].rows * (zoomLevels[k].size - SPRITE_CROP) <= SCREEN_WIDTH &&
+            HUD_HEIGHT + zoomLevels[k].cols * (zoomLevels[k].size - SPRITE_CROP) <= SCREEN_HEIGHT &&
+            zoomLevels[k].mines < zoomLevels[k].rows * zoomLevels[k].cols && zoomFits(k + 1));
+}
+static_assert(zoomFits(0), "every zoom level's board must fit the arrays and the screen");
+static_assert(ZOOM_DEFAULT < ZOOM_LEVELS, "ZOOM_DEFAULT must be one of the zoom levels");
 
 
 // global variables
-cell grid[8][8]; // 8x8 grid of cells
+uint8_t grid[MAX_ROWS][MAX_COLS]; // cells, see CELL_STATUS etc.
 uint8_t gridX = 0;
 uint8_t gridY = 0;
 bool gameLost = false;
 bool gameWon = false;
+#ifdef LCD_STATS
+uint32_t lcdBytes = 0; // bytes sent to the LCD since the last report
+uint16_t lcdWindows = 0; // windows opened since the last report
+#endif
+uint16_t boardSeed = 0xACE1; // lfsr seed for the next board, randomly chosen
+uint8_t flagsPlaced = 0;
+uint16_t gameSeconds = 0;
+
+// board and cell geometry of the current zoom level, set by setZoom()
+uint8_t zoom = ZOOM_DEFAULT;
+uint8_t boardRows = 0;
+uint8_t boardCols = 0;
+uint8_t boardMines = 0;
+uint16_t lineMask = 0; // the boardCols low bits of a line
+uint8_t spriteSize = 0;
+uint8_t spriteBytes = 0;
+const uint8_t *spriteData = NULL; // PROGMEM sprite set
+uint8_t cellPitch = 0;
+lcdCoord boardX0 = 0;
+lcdCoord boardY0 = 0; // the HUD sits right above it
+bool boardResized = false; // the LCD has to clear what the last board left around the new one
+
+uint16_t mineCells[MAX_ROWS]; // bit j of mineCells[i] = mine at (i, j)
+uint16_t emptyCells[MAX_ROWS]; // no mine on or around the cell, flood fill spreads from these
+uint8_t cellsRevealed = 0; // non-mine cells revealed so far
+
+// difficulty metrics, efficiency = solved3BV / boardClicks
+// #define MIN_3BV 10 // reject boards easier than this
+#ifndef MIN_3BV
+#define MIN_3BV 0
+#endif
+#define MAX_BOARD_TRIES 8
+coPoint boardGenCo = CO_DONE; // resume point of boardReady(), CO_DONE = no board being generated
+uint8_t boardTries = 0;
+uint16_t openedCells[MAX_ROWS]; // empty cells of the openings clicked open so far
+uint16_t isolatedCells[MAX_ROWS]; // numbered cells with no opening next to them
+uint8_t board3BV = 0;
+uint8_t solved3BV = 0;
+uint16_t boardClicks = 0;
+uint16_t sysTime = 0; // ms since boot, advanced by TimerISR(), wraps
+
+// animation engine
+#define MAX_ANIMATIONS 8
+#define CASCADE_STEP 40 // ms between rings of a reveal cascade
+#define SWEEP_STEP 60 // ms between columns of the win sweep
+#define EXPLOSION_STAGGER 150 // ms between mines going off after a loss
+animSlot animSlots[MAX_ANIMATIONS];
+uint8_t cascadeX = 0; // origin of the cascade
+uint8_t cascadeY = 0;
+uint8_t cascadeRing = 0; // next ring around the origin to show, 0 = no cascade
+uint16_t cascadeNext = 0;
+uint8_t sweepCol = 0xFF; // next column of the win sweep, 0xFF = no sweep
+uint16_t sweepNext = 0;
+uint16_t heldCells[MAX_ROWS]; // revealed, but waiting for the cascade to reach them
+
+// board write sections: grid[][] and the cursor only change inside one
+// the tasks run one after another in TimerISR(), so a section is only open between ticks when
+// a writer keeps it open on purpose (boardReady() generating a board), the renderer then leaves
+// the board alone instead of drawing it half-made
+// it's a flag, not a lock: the renderer reads grid[][] in place, a write that preempted it
+// mid-draw would go unnoticed, the copy it used to draw from made that safe but cost a second
+// board's worth of RAM, so it went, nothing preempts the renderer as the tasks are now
+uint8_t boardWriteDepth = 0; // open write sections, they nest, 0 = the board is stable
+
+// board transactions: Game_Tick applies a tick's input between txnBegin() and txnCommit(), so
+// a chord or a cascade lands on the board, and on screen, as one change, the actions record
+// the cells they changed and the state transitions they caused in txn
+#define TXN_LOST 0x01 // a mine went off
+#define TXN_WON 0x02 // the last safe cell was revealed
+#define TXN_NEW_GAME 0x04 // a new board was started, what the transaction did before it is void
+boardTxn txn; // the open transaction, or the last one committed
+uint16_t boardDirty[MAX_ROWS]; // cells committed since the renderer last took them
+
+// time-sliced rendering, Timer1 runs free at 2 MHz as the frame clock
+uint16_t frameStartTime = 0; // TCNT1 at the start of the LCD tick
+uint16_t drawPending[MAX_ROWS]; // cells the renderer still has to bring up to date
+uint8_t drawCursorX = 0; // cursor cell as of the last drawScreen()
+uint8_t drawCursorY = 0;
+uint8_t drawn[MAX_ROWS][MAX_COLS]; // look byte on screen per cell, DRAWN_NONE = not drawn
+#define DRAWN_NONE 0xFF
+
+// digits currently on the HUD, 0xFF = not drawn yet
+uint8_t hudShown[3 * HUD_DIGITS] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+uint8_t screenColor = PAL_BLACK; // palette color of the last full screen fill, under everything drawn since
 
+// versus link messages: a header byte with bit 7 set, 0x80 | op << 4 | arg (4 bits),
+// followed by payload bytes with bit 7 clear, so a receiver can always resync on the next header
+#define LINK_CURSOR 0 // arg = x, payload: y
+#define LINK_REVEAL 1 // arg = x, payload: y
+#define LINK_FLAG 2 // arg = x, payload: y
+#define LINK_SEED 3 // arg = seed bits 15..12, payload: bits 11..6, bits 5..0
+#define LINK_STATE 4 // arg = 1 lost, 2 won
+#define LINK_HEADER(op, arg) (0x80 | ((op) << 4) | ((arg) & 0x0F))
 
-// reads pixel from progmem
-uint16_t readGraphicPixel(const uint16_t *gfx, uint8_t row, uint8_t col) {
-    return pgm_read_word(&gfx[row * 16 + col]);
+// the opponent's side of the board, same mines as ours
+uint16_t oppRevealed[MAX_ROWS]; // bit j of oppRevealed[i] = cell (i, j)
+uint16_t oppFlagged[MAX_ROWS];
+uint8_t oppCellsRevealed = 0;
+uint8_t oppX = 0; // opponent's cursor
+uint8_t oppY = 0;
+uint8_t oppState = 0; // 1 lost, 2 won
+uint16_t linkSeed = 0; // seed of the board we are on, sent to the opponent
+bool linkMoved = false; // set once we have revealed or flagged, the board is then locked in
+
+// input events: Joystick_Tick only turns samples into these, Game_Tick applies them in batches
+// the queue is single producer / single consumer and lock-free, anything else that injects
+// input must push from the same context as Joystick_Tick (inside the scheduler)
+#define EVENT_MOVE 0 // arg: dx in the high nibble, dy in the low nibble, both signed
+#define EVENT_PRESS 1 // short press on the cursor cell: reveal
+#define EVENT_LONG_PRESS 2 // long press on the cursor cell: toggle the flag
+#define EVENT_CURSOR 3 // arg: x in the high nibble, y in the low nibble, move the cursor there
+#define EVENT_MOVE_ARG(dx, dy) ((uint8_t)(((dx) << 4) | ((dy) & 0x0F)))
+#define EVENT_QUEUE_SIZE 16 // must be a power of two
+gameEvent eventQueue[EVENT_QUEUE_SIZE];
+volatile uint8_t eventHead = 0; // written by the producer
+volatile uint8_t eventTail = 0; // written by the consumer
+uint8_t eventsDropped = 0; // events lost to a full queue
+uint8_t inputEvents = 0; // events pushed so far, dropped ones too, wraps, see lcdActivity()
+bool lcdNewBoard = false; // a new board or zoom level, lcdActivity() wakes the panel for it as for input
+
+// commands (COMMAND_MODE), header 0x80 | cmd << 4 | arg, then payload bytes with bit 7 clear
+// a batch has to fit in the UART RX buffer, end it with CMD_DUMP and wait for the reply
+// before sending the next one
+#define CMD_MOVE 0 // arg = x, payload: y, puts the cursor on (x, y)
+#define CMD_REVEAL 1 // reveals the cursor cell, like a short press
+#define CMD_FLAG 2 // toggles the flag on the cursor cell, like a long press
+#define CMD_RESEED 3 // arg = seed bits 15..12, payload: bits 11..6, bits 5..0, starts a new game
+#define CMD_DUMP 4 // replies with CMD_DUMP's header (arg = zoom level), then gridX, gridY, state
+                   // (0 playing, 1 lost, 2 won), cells revealed, flags, clicks (capped at 255), 3BV,
+                   // and a byte per cell of the level's board, column by column:
+                   // status | revealed << 4 | flagged << 5
+                   // commands after it wait until it has been sent
+#define CMD_ZOOM 5 // arg = zoom level, starts a new game on the next board at that level
+#define CMD_SHOT 6 // replies with a screenshot rebuilt from what was drawn, see shotStep(): CMD_SHOT's
+                   // header, width and height (high byte first), the palette (PALETTE_SIZE 5-6-5
+                   // colors, high byte first), then the pixels row by row in runs, a byte per run:
+                   // (length - 1) << 3 | palette index, tools/screenshot.py turns it into a PNG
+                   // commands after it wait until it has been sent
+#define SHOT_RUN_MAX 32
+#define SHOT_HEADER (5 + 2 * PALETTE_SIZE)
+static_assert(PALETTE_SIZE <= 8, "a screenshot run has 3 bits for the palette index");
+coPoint shotCo = CO_DONE; // resume point of shotStep(), CO_DONE = no screenshot being sent
+#define DUMP_HEADER 8
+coPoint dumpCo = CO_DONE; // resume point of dumpStep(), CO_DONE = no dump being sent
+
+
+// reads a pixel's palette index from progmem
+uint8_t readGraphicPixel(uint8_t id, uint8_t row, uint8_t col) {
+    uint8_t pair = pgm_read_byte(&spriteData[id * spriteBytes + (row * spriteSize + col) / 2]);
+    return (col & 1) ? (pair & 0x0F) : (pair >> 4);
+}
+
+#ifdef LCD_CAPTURE
+// queues a byte of the capture stream, waiting for room if the UART is behind
+void captureByte(uint8_t data) {
+    while (!uart_send(data)) { }
+}
+#endif
+
+// marks the end of an LCD tick in the capture stream
+void lcdCaptureFrame() {
+#ifdef LCD_CAPTURE
+    captureByte(CAPTURE_FRAME);
+#endif
 }
 
 // send command to the LCD
@@ -101,31 +431,83 @@ void spiWriteCommand(uint8_t command) {
   // send command, wait for transmission to complete
   SPDR = command;
   while (!(SPSR & (1 << SPIF))); 
+#ifdef LCD_STATS
+  lcdBytes++;
+#endif
+#ifdef LCD_CAPTURE
+  captureByte(CAPTURE_COMMAND);
+  captureByte(command);
+#endif
 
   // pull cs high
   PORTB |= (1 << LCD_CS);
 }
 
+// clocks a data byte out, CS and A0 are left as the caller set them
+void spiSendData(uint8_t data) {
+    // send data, wait for transmission to complete
+    SPDR = data;
+    while (!(SPSR & (1 << SPIF))); 
+#ifdef LCD_STATS
+    lcdBytes++;
+#endif
+#ifdef LCD_CAPTURE
+    if (data >= CAPTURE_ESCAPE) { captureByte(CAPTURE_ESCAPE); }
+    captureByte(data);
+#endif
+}
+
 // send data to the LCD
 void spiWriteData(uint8_t data) {
-
-    // configure PC0 and PC1 as inputs
-    PORTC |= ~(1 << JOYSTICK_VRX);
-    PORTC |= ~(1 << JOYSTICK_VRY);
-
     // pull A0 high to specify data
     PORTB |= (1 << LCD_A0);
     // pull cs low
     PORTB &= ~(1 << LCD_CS);
 
-    // send data, wait for transmission to complete
-    SPDR = data;
-    while (!(SPSR & (1 << SPIF))); 
+    spiSendData(data);
 
     // pull cs high
     PORTB |= (1 << LCD_CS);
 }
 
+// send a byte of pixel data, on a burst panel CS and A0 already stay put since RAMWR
+void spiWritePixelData(uint8_t data) {
+    if (Display::burst) { spiSendData(data); }
+    else { spiWriteData(data); }
+}
+
+// send two pixels to the LCD in the active pixel format
+void spiWritePixels(uint16_t c0, uint16_t c1) {
+#ifdef COLOR_12BIT
+    c0 = COLOR_TO_444(c0);
+    c1 = COLOR_TO_444(c1);
+    spiWritePixelData(c0 >> 4);
+    spiWritePixelData(((c0 & 0x0F) << 4) | (c1 >> 8));
+    spiWritePixelData(c1 & 0xFF);
+#else
+    spiWritePixelData(c0 >> 8);
+    spiWritePixelData(c0 & 0xFF);
+    spiWritePixelData(c1 >> 8);
+    spiWritePixelData(c1 & 0xFF);
+#endif
+}
+
+// send two pixels given as palette indices, no color conversion on the way
+void spiWritePalettePair(uint8_t a, uint8_t b) {
+    const uint8_t *pa = lcdPalette[a];
+    const uint8_t *pb = lcdPalette[b];
+#ifdef COLOR_12BIT
+    spiWritePixelData(pgm_read_byte(&pa[0]));
+    spiWritePixelData(pgm_read_byte(&pa[1]) | pgm_read_byte(&pb[2]));
+    spiWritePixelData(pgm_read_byte(&pb[3]));
+#else
+    spiWritePixelData(pgm_read_byte(&pa[0]));
+    spiWritePixelData(pgm_read_byte(&pa[1]));
+    spiWritePixelData(pgm_read_byte(&pb[0]));
+    spiWritePixelData(pgm_read_byte(&pb[1]));
+#endif
+}
+
 // GPIO initialization, call before tasks in main
 void gpioInit() {
     // SPI pins
@@ -137,6 +519,8 @@ void gpioInit() {
 
     // configure joystick pins as input
     DDRC &= ~(1 << JOYSTICK_VRX) & ~(1 << JOYSTICK_VRY) & ~(1 << SELECT_BUTTON);
+    // pull-up on the select button only, the joystick's ADC inputs stay floating
+    PORTC |= (1 << SELECT_BUTTON);
 
     PORTB |= (1 << PB2); // pull SS
     PORTB |= (1 << LCD_CS); // pull cs high
@@ -145,238 +529,1278 @@ void gpioInit() {
 
     // enable spi, set as master
     SPCR = (1<<SPE) | (1<<MSTR);
-    // SPSR = (1 << SPI2X);
-}
-
-// LCD initialization
-void lcdInit() {
-    // lcd initialization, refer to st7735 datasheet for details
-
-    // hardware reset
-    PORTB &= ~(1 << LCD_RESET); // bring reset low
-    _delay_ms(200);
-    PORTB |= (1 << LCD_RESET); // bring reset high
-    _delay_ms(200);
-
-    // initialize SPI
-    spiWriteCommand(0x01); // send SWRESET command
-    _delay_ms(150);
-    spiWriteCommand(0x11); // send SLPOUT command
-    _delay_ms(200);
-
-    spiWriteCommand(0x3A); // send COLMOD command
-    spiWriteData(0x05); // set mode to 16-bit color
-    _delay_ms(10);
-    spiWriteCommand(0x29); // send DISPON command
-    _delay_ms(200);
-
-    spiWriteCommand(0x36); // send MADCTL command
-    spiWriteData(0xC8); // set memory data access control
-
-    // fillRect(0, 0, LCD_WIDTH, LCD_HEIGHT, BLACK); // fill screen with black
-
-    // create grid
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            grid[i][j].status = EMPTY;
-            grid[i][j].revealed = false;
-            grid[i][j].flagged = false;
-            grid[i][j].selected = false;
-            grid[i][j].gfx = (const uint16_t*)emptyUnrevealedGrid;
-        }
-    }
+    // double the SPI clock for panels that keep up
+    if (Display::spi2x) { SPSR = (1 << SPI2X); }
+
+    // Timer1 free running, /8 prescaler: 0.5 us per count, wraps every 32 ms
+    TCCR1A = 0;
+    TCCR1B = (1 << CS11);
 }
 
-// grid initialization
-void initGrid() {
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            grid[i][j].status = EMPTY;
-            grid[i][j].revealed = false;
-            grid[i][j].flagged = false;
-            grid[i][j].selected = false;
-            grid[i][j].gfx = (const uint16_t*) emptyUnrevealedGrid;
+// marks the start of an LCD tick for the render budget
+void frameStart() {
+    frameStartTime = TCNT1;
+}
+
+// us since frameStart(), valid for up to 32 ms
+uint16_t frameElapsed() {
+    return (uint16_t)(TCNT1 - frameStartTime) / 2;
+}
+
+coPoint lcdInitCo = 0; // resume point of lcdInit()
+uint16_t lcdWake = 0; // sysTime lcdInit() sleeps until
+uint8_t lcdInitPos = 0; // next entry of the display's init sequence to send
+
+// brings the panel up, call it every LCD tick until it returns true
+// the reset is released, the init sequence sent and the screen cleared a step at a time,
+// sleeping as long as the panel asks in between, so other tasks keep running while it settles
+// the reset pin is pulled low before the first call
+bool lcdInit() {
+    const uint8_t *seq = Display::initSequence();
+    CO_BEGIN(lcdInitCo);
+    CO_SLEEP(lcdInitCo, lcdWake, 200);
+    PORTB |= (1 << LCD_RESET);
+    CO_SLEEP(lcdInitCo, lcdWake, 200);
+
+    // one entry of the init sequence per step, see display.h
+    for (lcdInitPos = 0; lcdInitPos < Display::initLength; ) {
+        spiWriteCommand(pgm_read_byte(&seq[lcdInitPos++]));
+        for (uint8_t n = pgm_read_byte(&seq[lcdInitPos++]); n > 0; --n) {
+            spiWriteData(pgm_read_byte(&seq[lcdInitPos++]));
         }
+        CO_SLEEP(lcdInitCo, lcdWake, pgm_read_byte(&seq[lcdInitPos++]));
     }
-    
-    // random mine placement
+
+    // clear the HUD strip and the margins around the board
+    fillScreen(PAL_BLACK);
+    CO_WAIT_UNTIL(lcdInitCo, fillStep());
+    CO_END(lcdInitCo);
+}
+
+// adds a 1-bit mask to a bit-sliced counter, one 4-bit count per bit position
+void countAdd(uint16_t m, uint16_t *c0, uint16_t *c1, uint16_t *c2, uint16_t *c3) {
+    uint16_t carry = *c0 & m;
+    *c0 ^= m;
+    m = carry;
+    carry = *c1 & m;
+    *c1 ^= m;
+    m = carry;
+    carry = *c2 & m;
+    *c2 ^= m;
+    *c3 |= carry;
+}
+
+// random mine placement, continues the lfsr sequence from boardSeed
+void placeMines() {
+    for (int i = 0; i < boardRows; ++i) { mineCells[i] = 0; }
+
     int minesPlaced = 0;
-    while (minesPlaced < 7) {
-        static uint16_t lfsr = 0xACE1; // randomly chosen seed
+    uint16_t lfsr = boardSeed;
+    while (minesPlaced < boardMines) {
         lfsr = (lfsr >> 1) ^ (-(lfsr & 1) & 0xB400); 
         
-        uint8_t x = lfsr % ROWS; 
-        uint8_t y = (lfsr / ROWS) % COLS; 
+        uint8_t x = lfsr % boardRows; 
+        uint8_t y = (lfsr / boardRows) % boardCols; 
         
         // check if position is already a mine
-        if (grid[x][y].status != EXPLODED_MINE) {
-            grid[x][y].status = EXPLODED_MINE;
+        if (!((mineCells[x] >> y) & 1)) {
+            mineCells[x] |= 1U << y;
             minesPlaced++;
+#ifdef SERIAL_DEBUG
             serial_println(x);
             serial_println(y);
-            serial_println(grid[x][y].status);
+            serial_println(EXPLODED_MINE);
+#endif
         }
     }
     
-    // calculate numbers for non-mine cells
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            if (grid[i][j].status != EXPLODED_MINE) {
-                uint8_t mineCount = 0;
-                
-                for (int di = -1; di <= 1; di++) {
-                    for (int dj = -1; dj <= 1; dj++) {
-                        if (di == 0 && dj == 0) continue; 
-                        int ni = i + di;
-                        int nj = j + dj;
-                        
-                        if (ni >= 0 && ni < ROWS && nj >= 0 && nj < COLS) {
-                            if (grid[ni][nj].status == EXPLODED_MINE) {
-                                mineCount++;
-                            }
-                        }
-                    }
-                }
-                
-                switch (mineCount) {
-                    case 0:
-                        grid[i][j].status = EMPTY;
-                        break;
-                    case 1:
-                        grid[i][j].status = NUMBER_1;
-                        break;
-                    case 2:
-                        grid[i][j].status = NUMBER_2;
-                        break;
-                    case 3:
-                        grid[i][j].status = NUMBER_3;
-                        break;
-                    default:
-                        grid[i][j].status = NUMBER_3;
-                        break;
-                }
+    // the next board continues the sequence
+    boardSeed = lfsr;
+}
+
+// calculate numbers for every cell from mineCells
+void countMines() {
+    // count neighbouring mines for a whole line at once: the 8 shifted neighbour
+    // masks are summed into 4 bit planes, so bit j of the planes is cell j's count
+    for (int i = 0; i < boardRows; ++i) {
+        uint16_t above = (i > 0) ? mineCells[i - 1] : 0;
+        uint16_t below = (i < boardRows - 1) ? mineCells[i + 1] : 0;
+        uint16_t line = mineCells[i];
+        uint16_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+
+        countAdd(above, &c0, &c1, &c2, &c3);
+        countAdd((uint16_t)(above << 1), &c0, &c1, &c2, &c3);
+        countAdd(above >> 1, &c0, &c1, &c2, &c3);
+        countAdd((uint16_t)(line << 1), &c0, &c1, &c2, &c3);
+        countAdd(line >> 1, &c0, &c1, &c2, &c3);
+        countAdd(below, &c0, &c1, &c2, &c3);
+        countAdd((uint16_t)(below << 1), &c0, &c1, &c2, &c3);
+        countAdd(below >> 1, &c0, &c1, &c2, &c3);
+
+        emptyCells[i] = ~(line | c0 | c1 | c2 | c3) & lineMask;
+
+        for (int j = 0; j < boardCols; ++j) {
+            uint8_t status;
+            if ((line >> j) & 1) { status = EXPLODED_MINE; }
+            else {
+                uint8_t mineCount = ((c0 >> j) & 1) | (((c1 >> j) & 1) << 1) | (((c2 >> j) & 1) << 2) | (((c3 >> j) & 1) << 3);
+                status = (mineCount < NUMBER_3) ? mineCount : NUMBER_3;
             }
+            grid[i][j] = (grid[i][j] & ~CELL_STATUS) | status;
         }
     }
 }
 
-// draws an individual 16 x 16 square
-// code: 0 = no mines, 1 = number 1, 2 = number 2, 3 = number 3, 4 = exploded mine, 5 = flag
-void drawSquare(uint8_t x0, uint8_t y0, const uint16_t *gfx) {
-  spiWriteCommand(CASET);
-  spiWriteData(0); spiWriteData(x0);
-  spiWriteData(0); spiWriteData(x0 + 15);
-  spiWriteCommand(RASET);
-  spiWriteData(0); spiWriteData(y0);
-  spiWriteData(0); spiWriteData(y0 + 15);
+// grows the cells set in opened (empty cells only) over the whole openings they are in,
+// empty cells touching each other, diagonals included, spread a line at a time until nothing changes
+void openingFill(uint16_t *opened) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint8_t i = 0; i < boardRows; ++i) {
+            uint16_t near = 0;
+            for (int8_t ni = i - 1; ni <= i + 1; ++ni) {
+                if (ni < 0 || ni >= boardRows) { continue; }
+                near |= opened[ni] | (uint16_t)(opened[ni] << 1) | (opened[ni] >> 1);
+            }
+            uint16_t line = near & emptyCells[i];
+            // runs along the line in one go
+            for (uint16_t was = 0; line != was;) {
+                was = line;
+                line |= ((uint16_t)(line << 1) | (line >> 1)) & emptyCells[i];
+            }
+            if (line != opened[i]) {
+                opened[i] = line;
+                changed = true;
+            }
+        }
+    }
+}
 
+// 3BV: the fewest clicks that clear the board, one per opening (group of touching
+// empty cells, revealed together by a single click) plus one per numbered cell
+// that no opening reaches
+void compute3BV() {
+    board3BV = 0;
+    solved3BV = 0;
+    boardClicks = 0;
 
-  spiWriteCommand(RAMWR);
-  for (uint8_t row = 0; row < 16; ++row) {
-    for (uint8_t col = 0; col < 16; ++col) {
-      uint16_t color = readGraphicPixel(gfx, row, col);
-      spiWriteData(color >> 8);
-      spiWriteData(color & 0xFF);
+    // one click per opening: fill from each empty cell no opening counted so far covers
+    for (uint8_t i = 0; i < boardRows; ++i) { openedCells[i] = 0; }
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        for (uint16_t m = emptyCells[i] & ~openedCells[i]; m; m = emptyCells[i] & ~openedCells[i]) {
+            openedCells[i] |= m & -m;
+            openingFill(openedCells);
+            board3BV++;
+        }
+    }
+    for (uint8_t i = 0; i < boardRows; ++i) { openedCells[i] = 0; }
+
+    // plus one per numbered cell that doesn't touch an opening
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        uint16_t near = 0;
+        for (int8_t ni = i - 1; ni <= i + 1; ++ni) {
+            if (ni < 0 || ni >= boardRows) { continue; }
+            near |= emptyCells[ni] | (uint16_t)(emptyCells[ni] << 1) | (emptyCells[ni] >> 1);
+        }
+        isolatedCells[i] = ~(near | mineCells[i]) & lineMask;
+        for (uint16_t m = isolatedCells[i]; m; m &= m - 1) { board3BV++; }
     }
-  }
 }
 
-void drawScreen() {
-    // draw the screen
-    for (uint8_t j = 0; j < 8; ++j) {
-        for (uint8_t i = 0; i < 8; ++i) {
-            const uint16_t *g;
-
-            // determine which graphic to show
-            if (grid[i][j].revealed) {
-                if (grid[i][j].selected) {
-                    switch (grid[i][j].status) {
-                    case EMPTY:
-                        g = (const uint16_t*)emptyRevealedSelectedGrid;
-                        break;
-                    case NUMBER_1:
-                        g = (const uint16_t*)number1SelectedGrid;
-                        break;
-                    case NUMBER_2:
-                        g = (const uint16_t*)number2SelectedGrid;
-                        break;
-                    case NUMBER_3:
-                        g = (const uint16_t*)number3SelectedGrid;
-                        break;
-                    case EXPLODED_MINE:
-                        g = (const uint16_t*)explosionMine1pxGrid;
-                        gameLost = true;
-                        break;
-                    case FLAG:
-                        g = (const uint16_t*)flagSelectedGrid;
-                        break;
-                    default:
-                        g = (const uint16_t*)emptyRevealedGrid;
-                        break;
-                    }
-                    if (grid[i][j].flagged) { g = ( const uint16_t*) flagGrid; }
+// updates the solved 3BV for cells that were just revealed, bit j of added[i] = cell (i, j)
+// each opening counts once, when its first cell is uncovered
+void update3BV(const uint16_t *added) {
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        for (uint16_t m = added[i] & isolatedCells[i]; m; m &= m - 1) { solved3BV++; }
+
+        for (uint16_t m = added[i] & emptyCells[i] & ~openedCells[i]; m; m = added[i] & emptyCells[i] & ~openedCells[i]) {
+            openedCells[i] |= m & -m;
+            openingFill(openedCells);
+            solved3BV++;
+        }
+    }
+}
+
+// brackets a change to grid[][] or gridX/gridY, sections may nest
+void boardWriteBegin() {
+    boardWriteDepth++;
+}
+
+void boardWriteEnd() {
+    boardWriteDepth--;
+}
+
+// true while no board write section is open, the renderer may read the board then
+bool boardStable() {
+    return boardWriteDepth == 0;
+}
+
+// opens a transaction, the actions applied until txnCommit() are one board write
+void txnBegin() {
+    for (uint8_t i = 0; i < MAX_ROWS; ++i) { txn.changed[i] = 0; }
+    txn.events = 0;
+    boardWriteBegin();
+}
+
+// records a cell an action changed
+void txnMark(uint8_t x, uint8_t y) {
+    txn.changed[x] |= 1U << y;
+}
+
+// closes the transaction and hands the cells it changed to the renderer all at once
+// returns it, it stays valid until the next txnBegin()
+const boardTxn *txnCommit() {
+    for (uint8_t i = 0; i < MAX_ROWS; ++i) { boardDirty[i] |= txn.changed[i]; }
+    boardWriteEnd();
+    return &txn;
+}
+
+// forgets what is on screen, the renderer redraws every cell
+void drawInvalidate() {
+    for (uint8_t i = 0; i < MAX_ROWS; ++i) {
+        drawPending[i] = (i < boardRows) ? lineMask : 0;
+        for (uint8_t j = 0; j < MAX_COLS; ++j) { drawn[i][j] = DRAWN_NONE; }
+    }
+}
+
+// grid initialization
+void initGrid() {
+    boardWriteBegin();
+    for (int i = 0; i < boardRows; ++i) {
+        heldCells[i] = 0;
+        for (int j = 0; j < boardCols; ++j) { grid[i][j] = EMPTY; }
+    }
+    drawInvalidate();
+    lcdNewBoard = true;
+    
+    cellsRevealed = 0;
+    grid[gridX][gridY] |= CELL_SELECTED;
+
+    // the board write section stays open until boardReady() has generated the mines
+    if (boardGenCo != CO_DONE) { boardWriteEnd(); }
+    boardGenCo = 0;
+}
+
+// generates the board initGrid() cleared, a pass per call, true once it is ready
+// until then the board write section is open, so the renderer never draws a half-made board,
+// and Game_Tick holds the input back
+bool boardReady() {
+    CO_BEGIN(boardGenCo);
+    // boards easier than MIN_3BV are thrown away, the seed sequence makes the retries repeatable
+    boardTries = 0;
+    do {
+        placeMines();
+        CO_YIELD(boardGenCo);
+        countMines();
+        compute3BV();
+#if MIN_3BV > 0
+        if (board3BV >= MIN_3BV) { break; }
+        CO_YIELD(boardGenCo);
+#else
+        break; // any board will do
+#endif
+    } while (++boardTries < MAX_BOARD_TRIES);
+    boardWriteEnd();
+    CO_END(boardGenCo);
+}
+
+// generates the rest of the board at once, for callers that have to see it straight away
+void boardFinish() {
+    while (!boardReady()) { }
+}
+
+// reveals the seed cells in a bitmask board and flood-fills out from the empty ones, never
+// into blocked cells, each pass spreads every newly revealed empty cell of a line at once
+// only this reveal's cells spread: an opening revealed before stays as it is, even if a
+// flag next to it was taken off since
+// seeds is used up, returns the number of cells newly revealed
+uint8_t floodReveal(uint16_t *revealed, const uint16_t *blocked, uint16_t *seeds) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        seeds[i] &= ~revealed[i];
+        revealed[i] |= seeds[i];
+        for (uint16_t m = seeds[i]; m; m &= m - 1) { count++; }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint8_t i = 0; i < boardRows; ++i) {
+            uint16_t from = seeds[i] & emptyCells[i];
+            seeds[i] = 0;
+            if (!from) { continue; }
+
+            uint16_t wide = (from | (uint16_t)(from << 1) | (from >> 1)) & lineMask;
+            for (int8_t ni = i - 1; ni <= i + 1; ++ni) {
+                if (ni < 0 || ni >= boardRows) { continue; }
+                uint16_t add = wide & ~blocked[ni] & ~revealed[ni];
+                if (!add) { continue; }
+                revealed[ni] |= add;
+                seeds[ni] |= add;
+                changed = true;
+                for (; add; add &= add - 1) { count++; }
+            }
+        }
+    }
+    return count;
+}
+
+// sets off every mine after (x, y) was hit, the game is lost
+void explodeMines(uint8_t x, uint8_t y) {
+    gameLost = true;
+    txn.events |= TXN_LOST;
+    soundPlay(soundExplosion);
+
+    // the mine that was hit goes first, the rest follow one after another
+    grid[x][y] |= CELL_REVEALED;
+    txnMark(x, y);
+    animStart(&explosionAnim, x, y, 0);
+    uint16_t delay = EXPLOSION_STAGGER;
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        for (uint8_t j = 0; j < boardCols; ++j) {
+            if ((grid[i][j] & (CELL_STATUS | CELL_REVEALED)) == EXPLODED_MINE) {
+                grid[i][j] |= CELL_REVEALED;
+                txnMark(i, j);
+                if (animStart(&explosionAnim, i, j, delay)) { delay += EXPLOSION_STAGGER; }
+            }
+        }
+    }
+}
+
+// reveals the cells set in pick (bit j of pick[i] = cell (i, j)) as one click, flood-filling
+// out from empty cells, revealed and flagged cells in it are left alone
+// (x, y) is where the click landed, the cascade is applied to the board at once and shown
+// ring by ring from there by the animation engine
+void revealCells(const uint16_t *pick, uint8_t x, uint8_t y) {
+    // flood fill on bitmasks, then mark what it uncovered
+    uint16_t revealed[MAX_ROWS];
+    uint16_t blocked[MAX_ROWS];
+    uint16_t added[MAX_ROWS];
+    bool any = false;
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        revealed[i] = 0;
+        blocked[i] = 0;
+        for (uint8_t j = 0; j < boardCols; ++j) {
+            if (grid[i][j] & CELL_REVEALED) { revealed[i] |= 1U << j; }
+            if (grid[i][j] & CELL_FLAGGED) { blocked[i] |= 1U << j; }
+        }
+        added[i] = pick[i] & ~revealed[i] & ~blocked[i];
+        if (added[i]) { any = true; }
+    }
+    if (!any) { return; }
+    boardWriteBegin();
+
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        uint16_t hit = added[i] & mineCells[i];
+        if (!hit) { continue; }
+        uint8_t j = 0;
+        while (!((hit >> j) & 1)) { j++; }
+        explodeMines(i, j);
+        boardWriteEnd();
+        return;
+    }
+
+    // one fill from all the picked cells
+    floodReveal(revealed, blocked, added);
+    boardClicks++;
+    soundPlay(soundReveal);
+
+    // what the fill added is what wasn't revealed on the board before
+    bool cascade = false;
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        for (uint8_t j = 0; j < boardCols; ++j) {
+            if (grid[i][j] & CELL_REVEALED) { revealed[i] &= ~(1U << j); }
+        }
+        added[i] = revealed[i];
+    }
+    update3BV(added);
+
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        uint16_t line = added[i];
+        for (uint8_t j = 0; j < boardCols; ++j) {
+            if (!((line >> j) & 1)) { continue; }
+            grid[i][j] |= CELL_REVEALED;
+            txnMark(i, j);
+            cellsRevealed++;
+            // the animation engine shows everything but the clicked cell ring by ring
+            if (i != x || j != y) {
+                heldCells[i] |= 1U << j;
+                cascade = true;
+            }
+        }
+    }
+    if (cascade) { animCascade(x, y); }
+
+    if (cellsRevealed == boardRows * boardCols - boardMines) {
+        gameWon = true;
+        txn.events |= TXN_WON;
+    }
+    boardWriteEnd();
+}
+
+// reveals a cell, flood-filling out from empty cells
+void revealCell(uint8_t x, uint8_t y) {
+    uint16_t pick[MAX_ROWS];
+    for (uint8_t i = 0; i < boardRows; ++i) { pick[i] = 0; }
+    pick[x] = 1U << y;
+    revealCells(pick, x, y);
+}
+
+// chord: a revealed number with as many flags around it as mines reveals the rest of its
+// neighbours in one click, a misplaced flag sets off the mine it left uncovered
+// the flags are checked against the real count, the tile tops out at 3
+// returns the neighbours it uncovered, a mine set off included, as a bit per cell of the
+// 3x3 block: bit (i - x + 1) * 3 + (j - y + 1) for cell (i, j)
+uint16_t chordCell(uint8_t x, uint8_t y) {
+    uint8_t status = grid[x][y] & CELL_STATUS;
+    if (!(grid[x][y] & CELL_REVEALED) || status == EMPTY || status == EXPLODED_MINE) { return 0; }
+
+    uint16_t pick[MAX_ROWS]; // the covered, unflagged neighbours
+    uint8_t mines = 0;
+    uint8_t flags = 0;
+    uint16_t around = (1U << y | (uint16_t)(1U << y << 1) | (1U << y >> 1)) & lineMask;
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        uint8_t d = (i > x) ? i - x : x - i;
+        uint16_t block = (d <= 1) ? around & ~((i == x) ? 1U << y : 0) : 0;
+        for (uint16_t m = block & mineCells[i]; m; m &= m - 1) { mines++; }
+        pick[i] = 0;
+        for (uint8_t j = 0; j < boardCols; ++j) {
+            if (!((block >> j) & 1)) { continue; }
+            if (grid[i][j] & CELL_FLAGGED) { flags++; }
+            else if (!(grid[i][j] & CELL_REVEALED)) { pick[i] |= 1U << j; }
+        }
+    }
+    if (flags != mines) { return 0; }
+    revealCells(pick, x, y);
+
+    uint16_t gained = 0;
+    for (int8_t i = x - 1; i <= x + 1; ++i) {
+        for (int8_t j = y - 1; j <= y + 1; ++j) {
+            if (i < 0 || i >= boardRows || j < 0 || j >= boardCols) { continue; }
+            if (((pick[i] >> j) & 1) && (grid[i][j] & CELL_REVEALED)) { gained |= 1U << ((i - x + 1) * 3 + (j - y + 1)); }
+        }
+    }
+    return gained;
+}
+
+// reveals a cell on the opponent's side of the board, flood-filling like revealCell()
+void oppReveal(uint8_t x, uint8_t y) {
+    if ((oppRevealed[x] >> y) & 1) { return; }
+    if ((mineCells[x] >> y) & 1) {
+        oppRevealed[x] |= 1U << y;
+        return;
+    }
+
+    uint16_t seeds[MAX_ROWS];
+    for (uint8_t i = 0; i < boardRows; ++i) { seeds[i] = 0; }
+    seeds[x] = 1U << y;
+    oppCellsRevealed += floodReveal(oppRevealed, oppFlagged, seeds);
+}
+
+// starts a versus game on the current board, tells the opponent which seed we are on
+void linkStart(uint16_t seed) {
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        oppRevealed[i] = 0;
+        oppFlagged[i] = 0;
+    }
+    oppCellsRevealed = 0;
+    oppState = 0;
+    linkSeed = seed;
+    linkMoved = false;
+    linkSend(LINK_SEED, seed >> 12, seed & 0x0FFF);
+}
+
+// queues a message for the opponent, dropped if the TX buffer can't take all of it
+void linkSend(uint8_t op, uint8_t arg, uint16_t payload) {
+#ifdef VERSUS_MODE
+    uint8_t len = (op == LINK_SEED) ? 3 : (op == LINK_STATE) ? 1 : 2;
+    if (uart_tx_free() < len) { return; }
+    uart_send(LINK_HEADER(op, arg));
+    if (op == LINK_SEED) {
+        uart_send((payload >> 6) & 0x3F);
+        uart_send(payload & 0x3F);
+    }
+    else if (op != LINK_STATE) { uart_send(payload & 0x7F); }
+#endif
+}
+
+// applies one message from the opponent
+void linkApply(uint8_t op, uint8_t arg, const uint8_t *payload) {
+    uint8_t y = payload[0];
+    if (op != LINK_SEED && op != LINK_STATE && (arg >= boardRows || y >= boardCols)) { return; }
+
+    switch (op) {
+        case LINK_CURSOR:
+            oppX = arg;
+            oppY = y;
+            break;
+        case LINK_REVEAL:
+            oppReveal(arg, y);
+            break;
+        case LINK_FLAG:
+            oppFlagged[arg] ^= 1U << y;
+            break;
+        case LINK_SEED: {
+            // both sides settle on the lower seed, as long as nobody has moved yet
+            uint16_t seed = ((uint16_t)arg << 12) | ((uint16_t)payload[0] << 6) | payload[1];
+            if (seed < linkSeed && !linkMoved) {
+                boardSeed = seed;
+                initGrid();
+                linkStart(seed);
+            }
+            break;
+        }
+        case LINK_STATE:
+            oppState = arg;
+            break;
+        default:
+            break;
+    }
+}
+
+// drains received bytes and applies complete messages, never waits for more
+// stops once a seed message starts a new board, the rest waits until the board is ready
+void linkPoll() {
+#ifdef VERSUS_MODE
+    static uint8_t op = 0xFF; // message being received, 0xFF = waiting for a header
+    static uint8_t arg = 0;
+    static uint8_t need = 0;
+    static uint8_t have = 0;
+    static uint8_t payload[2];
+
+    int16_t data;
+    while (boardGenCo == CO_DONE && (data = uart_read()) >= 0) {
+        if (data & 0x80) {
+            // a header always starts a new message, whatever was partial is dropped
+            op = (data >> 4) & 0x07;
+            arg = data & 0x0F;
+            need = (op == LINK_SEED) ? 2 : (op == LINK_STATE) ? 0 : 1;
+            have = 0;
+        }
+        else if (op != 0xFF && have < need) {
+            payload[have++] = data;
+        }
+        else { continue; }
+
+        if (op != 0xFF && have == need) {
+            linkApply(op, arg, payload);
+            op = 0xFF;
+        }
+    }
+#endif
+}
+
+// queues an input event, returns false (and counts it) if the queue is full
+bool eventPush(uint8_t type, uint8_t arg) {
+    inputEvents++;
+    uint8_t head = eventHead;
+    uint8_t next = (head + 1) & (EVENT_QUEUE_SIZE - 1);
+    if (next == eventTail) {
+        eventsDropped++;
+        return false;
+    }
+    eventQueue[head].type = type;
+    eventQueue[head].arg = arg;
+    asm volatile("" ::: "memory"); // the event is written before it is published
+    eventHead = next;
+    return true;
+}
+
+// takes the oldest input event, returns false if there is none
+bool eventPop(gameEvent *ev) {
+    uint8_t tail = eventTail;
+    if (tail == eventHead) { return false; }
+    *ev = eventQueue[tail];
+    asm volatile("" ::: "memory"); // the event is read before its slot is handed back
+    eventTail = (tail + 1) & (EVENT_QUEUE_SIZE - 1);
+    return true;
+}
+
+// applies one input event to the game
+void eventApply(gameEvent ev) {
+    boardWriteBegin();
+    switch (ev.type) {
+        case EVENT_MOVE:
+        case EVENT_CURSOR: {
+            uint8_t x = gridX;
+            uint8_t y = gridY;
+            if (ev.type == EVENT_MOVE) {
+                int8_t dx = (int8_t)ev.arg >> 4;
+                int8_t dy = (int8_t)(ev.arg << 4) >> 4;
+                if ((dx > 0 && x < boardRows - 1) || (dx < 0 && x > 0)) { x += dx; }
+                if ((dy > 0 && y < boardCols - 1) || (dy < 0 && y > 0)) { y += dy; }
+            }
+            else if ((ev.arg >> 4) < boardRows && (ev.arg & 0x0F) < boardCols) {
+                x = ev.arg >> 4;
+                y = ev.arg & 0x0F;
+            }
+            if (x == gridX && y == gridY) { break; }
+            grid[gridX][gridY] &= ~CELL_SELECTED;
+            grid[x][y] |= CELL_SELECTED;
+            txnMark(gridX, gridY);
+            txnMark(x, y);
+            gridX = x;
+            gridY = y;
+            linkSend(LINK_CURSOR, gridX, gridY);
+            break;
+        }
+
+        case EVENT_LONG_PRESS:
+            if (!(grid[gridX][gridY] & CELL_REVEALED) && !gameLost && !gameWon) {
+                grid[gridX][gridY] ^= CELL_FLAGGED;
+                txnMark(gridX, gridY);
+                if (grid[gridX][gridY] & CELL_FLAGGED) { flagsPlaced++; }
+                else { flagsPlaced--; }
+                soundPlay(soundFlag);
+                linkSend(LINK_FLAG, gridX, gridY);
+                linkMoved = true;
+#ifdef SERIAL_DEBUG
+                serial_println("Long Press: Toggled Flag at (");
+                serial_println(gridX);
+                serial_println(", ");
+                serial_println(gridY);
+                serial_println(")");
+#endif
+            }
+            break;
+
+        case EVENT_PRESS:
+            if (!gameLost && !gameWon) {
+                if (!(grid[gridX][gridY] & CELL_REVEALED)) {
+                    revealCell(gridX, gridY);
+                    linkSend(LINK_REVEAL, gridX, gridY);
                 }
                 else {
-                    // cell is revealed, show the actual content
-                    switch (grid[i][j].status) {
-                        case EMPTY:
-                            g = (const uint16_t*)emptyRevealedGrid;
-                            break;
-                        case NUMBER_1:
-                            g = (const uint16_t*)number1Grid;
-                            break;
-                        case NUMBER_2:
-                            g = (const uint16_t*)number2Grid;
-                            break;
-                        case NUMBER_3:
-                            g = (const uint16_t*)number3Grid;
-                            break;
-                        case EXPLODED_MINE:
-                            g = (const uint16_t*)explosionMine1pxGrid;
-                            gameLost = true;
-                            break;
-                        default:
-                            g = (const uint16_t*)emptyRevealedGrid;
-                            break;
+                    // a revealed number chords, the opponent floods from each neighbour it
+                    // uncovered, or sees the mine it set off
+                    uint16_t gained = chordCell(gridX, gridY);
+                    for (uint8_t k = 0; gained; ++k, gained >>= 1) {
+                        if (gained & 1) { linkSend(LINK_REVEAL, gridX + k / 3 - 1, gridY + k % 3 - 1); }
                     }
                 }
+                linkMoved = true;
+#ifdef SERIAL_DEBUG
+                serial_println(gridX);
+                serial_println(gridY);
+#endif
+            }
+            break;
 
-            } 
+        default:
+            break;
+    }
+    boardWriteEnd();
+}
 
-            else {
-                if (grid[i][j].selected) { 
-                    if (grid[i][j].flagged) { g = (const uint16_t*) flagSelectedGrid; }
-                    else { g = (const uint16_t*) emptyUnrevealedSelectedGrid; }
-                }
-                else if (grid[i][j].flagged) { g = (const uint16_t*) flagGrid; }
-                else { g = (const uint16_t*) emptyUnrevealedGrid; }
-            }
+// switches the board and cell geometry to a zoom level, out of range levels are ignored
+// the board changes size, so the caller starts a new game on it
+void setZoom(uint8_t level) {
+    if (level >= ZOOM_LEVELS) { return; }
+    boardWriteBegin();
+    const zoomLevel *z = &zoomLevels[level];
+    zoom = level;
+    spriteSize = pgm_read_byte(&z->size);
+    spriteBytes = spriteSize * spriteSize / 2;
+    spriteData = (const uint8_t*)pgm_read_ptr(&z->sprites);
+    boardRows = pgm_read_byte(&z->rows);
+    boardCols = pgm_read_byte(&z->cols);
+    boardMines = pgm_read_byte(&z->mines);
+    lineMask = 0xFFFF >> (16 - boardCols);
+    cellPitch = spriteSize - SPRITE_CROP;
+    boardX0 = SCREEN_X0 + (SCREEN_WIDTH - boardRows * cellPitch) / 2;
+    boardY0 = SCREEN_Y0 + HUD_HEIGHT + (SCREEN_HEIGHT - HUD_HEIGHT - boardCols * cellPitch) / 2;
+
+    // keep the cursor on the board
+    if (gridX >= boardRows) { gridX = boardRows - 1; }
+    if (gridY >= boardCols) { gridY = boardCols - 1; }
+    drawCursorX = gridX;
+    drawCursorY = gridY;
+    boardResized = true;
+    lcdNewBoard = true;
+    boardWriteEnd();
+}
+
+// throws the current game away and starts a new board from seed
+// Game_Tick leaves its game over states on TXN_NEW_GAME, LCD_Tick once gameLost is clear
+void newGame(uint16_t seed) {
+    for (uint8_t i = 0; i < MAX_ROWS; ++i) { txn.changed[i] = 0; }
+    txn.events = TXN_NEW_GAME;
+    for (uint8_t k = 0; k < MAX_ANIMATIONS; ++k) { animSlots[k].anim = NULL; }
+    cascadeRing = 0;
+    sweepCol = 0xFF;
+    for (uint8_t k = 0; k < 3 * HUD_DIGITS; ++k) { hudShown[k] = 0xFF; }
+
+    gameLost = false;
+    gameWon = false;
+    flagsPlaced = 0;
+    gameSeconds = 0;
+    boardSeed = seed;
+    initGrid();
+}
 
-            
-            int x0 = (16 * i) + 2; // x0 coordinate of the square
-            int y0 = (16 * j) + 3; // y0 coordinate of the square
-            drawSquare(x0, y0, g);
+#ifdef COMMAND_MODE
+// applies the events queued so far, so a command that reads or resets the game sees them
+void commandFlush() {
+    gameEvent ev;
+    while (eventPop(&ev)) { eventApply(ev); }
+}
+
+// a dump being sent, see dumpStep()
+uint8_t dumpI, dumpJ; // next cell
+
+// sends the dump CMD_DUMP asked for, true once it's out (or when there is none)
+// the header goes out in one piece, the cells as the TX buffer frees up, so a reply never
+// waits on the line, TimerISR() calls this every tick so it keeps up with the baud rate
+// commands wait until it's out, only joystick input could change the board in between
+bool dumpStep() {
+    CO_BEGIN(dumpCo);
+    CO_WAIT_UNTIL(dumpCo, uart_tx_free() >= DUMP_HEADER);
+    uart_send(LINK_HEADER(CMD_DUMP, zoom));
+    uart_send(gridX);
+    uart_send(gridY);
+    uart_send(gameLost ? 1 : gameWon ? 2 : 0);
+    uart_send(cellsRevealed);
+    uart_send(flagsPlaced);
+    uart_send(boardClicks < 0xFF ? boardClicks : 0xFF);
+    uart_send(board3BV);
+    for (dumpI = 0; dumpI < boardRows; ++dumpI) {
+        for (dumpJ = 0; dumpJ < boardCols; ++dumpJ) {
+            CO_WAIT_UNTIL(dumpCo, uart_send(grid[dumpI][dumpJ] & (CELL_STATUS | CELL_REVEALED | CELL_FLAGGED)));
         }
     }
+    CO_END(dumpCo);
 }
 
-// fills the enture screen wth a color
-void fillRect(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t color) {
-  uint32_t count = (uint32_t)(x1 - x0 + 1) * (y1 - y0 + 1);
+// parses received commands into input events, stops while the event queue is nearly full
+// so nothing is dropped, or once a dump or screenshot is being sent so no reply lands in the
+// middle of it, the bytes left wait in the RX buffer for the next call
+void commandPoll() {
+    static uint8_t cmd = 0xFF; // command being received, 0xFF = waiting for a header
+    static uint8_t arg = 0;
+    static uint8_t need = 0;
+    static uint8_t have = 0;
+    static uint8_t payload[2];
 
-  // Set window
-  spiWriteCommand(CASET);
-  spiWriteData(0x00); spiWriteData(x0);
-  spiWriteData(0x00); spiWriteData(x1);
+    while (shotCo == CO_DONE && dumpCo == CO_DONE && ((eventTail - eventHead - 1) & (EVENT_QUEUE_SIZE - 1)) >= 2) {
+        int16_t data = uart_read();
+        if (data < 0) { break; }
+        if (data & 0x80) {
+            // a header always starts a new command, whatever was partial is dropped
+            cmd = (data >> 4) & 0x07;
+            arg = data & 0x0F;
+            need = (cmd == CMD_MOVE) ? 1 : (cmd == CMD_RESEED) ? 2 : 0;
+            have = 0;
+        }
+        else if (cmd != 0xFF && have < need) {
+            payload[have++] = data;
+        }
+        else { continue; }
 
-  spiWriteCommand(RASET);
-  spiWriteData(0x00); spiWriteData(y0);
-  spiWriteData(0x00); spiWriteData(y1);
+        if (cmd == 0xFF || have < need) { continue; }
+        switch (cmd) {
+            case CMD_MOVE:
+                eventPush(EVENT_CURSOR, (arg << 4) | (payload[0] & 0x0F));
+                break;
+            case CMD_REVEAL:
+                eventPush(EVENT_PRESS, 0);
+                break;
+            case CMD_FLAG:
+                eventPush(EVENT_LONG_PRESS, 0);
+                break;
+            case CMD_RESEED:
+                commandFlush();
+                newGame(((uint16_t)arg << 12) | ((uint16_t)payload[0] << 6) | payload[1]);
+                boardFinish();
+                break;
+            case CMD_DUMP:
+                commandFlush();
+                dumpCo = 0;
+                break;
+            case CMD_ZOOM:
+                commandFlush();
+                setZoom(arg);
+                newGame(boardSeed);
+                boardFinish();
+                break;
+            case CMD_SHOT:
+                shotStart();
+                break;
+            default:
+                break;
+        }
+        cmd = 0xFF;
+    }
+}
+#endif
 
-  // Write pixels
+// opens a window on the LCD and starts a pixel write into it
+// a burst panel then keeps CS low and A0 high for the pixels, until the next command
+void lcdSetWindow(lcdCoord x0, lcdCoord y0, lcdCoord x1, lcdCoord y1) {
+#ifdef LCD_STATS
+  lcdWindows++;
+#endif
+  spiWriteCommand(CASET);
+  spiWriteData(x0 >> 8); spiWriteData(x0 & 0xFF);
+  spiWriteData(x1 >> 8); spiWriteData(x1 & 0xFF);
+  spiWriteCommand(RASET);
+  spiWriteData(y0 >> 8); spiWriteData(y0 & 0xFF);
+  spiWriteData(y1 >> 8); spiWriteData(y1 & 0xFF);
   spiWriteCommand(RAMWR);
-  for (uint32_t i = 0; i < count; ++i) {
-    spiWriteData(color >> 8);
-    spiWriteData(color & 0xFF);
+  if (Display::burst) {
+    PORTB |= (1 << LCD_A0);
+    PORTB &= ~(1 << LCD_CS);
+  }
+}
+
+// sends rows r0..r1, columns c0..c1 of a sprite into the open window
+// pixels go out in pairs, the odd one left at the end is paired with the
+// first pixel of the window, which is where the extra pixel wraps to
+void spiWriteSpriteRect(uint8_t id, uint8_t r0, uint8_t r1, uint8_t c0, uint8_t c1) {
+  uint8_t pending = 0;
+  bool havePending = false;
+  for (uint8_t row = r0; row <= r1; ++row) {
+    for (uint8_t col = c0; col <= c1; ++col) {
+      uint8_t color = readGraphicPixel(id, row, col);
+      if (havePending) { spiWritePalettePair(pending, color); }
+      else { pending = color; }
+      havePending = !havePending;
+    }
   }
-}
\ No newline at end of file
+  if (havePending) { spiWritePalettePair(pending, readGraphicPixel(id, r0, c0)); }
+}
+
+// draws an individual square, the cropped cellPitch x cellPitch part of a sprite of the current zoom level
+void drawSquare(lcdCoord x0, lcdCoord y0, uint8_t id) {
+  lcdSetWindow(x0, y0, x0 + cellPitch - 1, y0 + cellPitch - 1);
+  spiWriteSpriteRect(id, SPRITE_CROP, spriteSize - 1, SPRITE_CROP, spriteSize - 1);
+}
+
+// draws one HUD digit, 6 x 8 including spacing so it fully covers the previous one
+// color is a palette index
+void drawDigit(lcdCoord x0, lcdCoord y0, uint8_t digit, uint8_t color) {
+  lcdSetWindow(x0, y0, x0 + HUD_GLYPH_WIDTH - 1, y0 + HUD_HEIGHT - 1);
+  for (uint8_t row = 0; row < HUD_HEIGHT; ++row) {
+    for (uint8_t col = 0; col < HUD_GLYPH_WIDTH; col += 2) {
+      uint8_t c[2];
+      for (uint8_t k = 0; k < 2; ++k) {
+        uint8_t bits = (col + k < 5) ? pgm_read_byte(&hudFont[digit][col + k]) : 0;
+        c[k] = ((bits >> row) & 1) ? color : PAL_BLACK;
+      }
+      spiWritePalettePair(c[0], c[1]);
+    }
+  }
+}
+
+// draws a counter on the HUD, only re-sending the digits that changed
+void drawCounter(lcdCoord x0, uint16_t value, uint8_t *shown, uint8_t color) {
+  for (int8_t k = HUD_DIGITS - 1; k >= 0; --k) {
+    uint8_t digit = value % 10;
+    value /= 10;
+    if (shown[k] != digit) {
+      drawDigit(x0 + k * HUD_GLYPH_WIDTH, boardY0 - HUD_HEIGHT, digit, color);
+      shown[k] = digit;
+    }
+  }
+}
+
+// HUD counters: 0 mines left on the left, 1 seconds played on the right
+// 2 in the middle: 3BV left to clear, or the opponent's safe cells left in versus mode
+lcdCoord hudCounterX(uint8_t counter) {
+  lcdCoord width = boardRows * cellPitch;
+  return (counter == 0) ? boardX0 :
+         (counter == 1) ? boardX0 + width - HUD_DIGITS * HUD_GLYPH_WIDTH :
+         boardX0 + (width - HUD_DIGITS * HUD_GLYPH_WIDTH) / 2;
+}
+
+// palette color of a HUD counter
+uint8_t hudColor(uint8_t counter) {
+#ifdef VERSUS_MODE
+  if (counter == 2) { return oppState == 1 ? PAL_RED : PAL_PURPLE; }
+#endif
+  return (counter == 0) ? PAL_RED : (counter == 1) ? PAL_YELLOW : PAL_GREEN;
+}
+
+void drawHud() {
+  uint16_t minesLeft = (flagsPlaced < boardMines) ? boardMines - flagsPlaced : 0;
+  uint16_t seconds = (gameSeconds < 999) ? gameSeconds : 999;
+  drawCounter(hudCounterX(0), minesLeft, &hudShown[0], hudColor(0));
+  drawCounter(hudCounterX(1), seconds, &hudShown[HUD_DIGITS], hudColor(1));
+#ifdef VERSUS_MODE
+  uint16_t oppLeft = boardRows * boardCols - boardMines - oppCellsRevealed;
+  drawCounter(hudCounterX(2), oppLeft, &hudShown[2 * HUD_DIGITS], hudColor(2));
+#else
+  drawCounter(hudCounterX(2), board3BV - solved3BV, &hudShown[2 * HUD_DIGITS], hudColor(2));
+#endif
+}
+
+// draws a square as a delta against the sprite already on screen
+// only the bounding box of the changed pixels is sent
+void drawSquareDelta(lcdCoord x0, lcdCoord y0, uint8_t from, uint8_t to) {
+  if (from == SPRITE_NONE) {
+    drawSquare(x0, y0, to);
+    return;
+  }
+
+  uint8_t r0 = 0xFF, r1 = 0, c0 = 0xFF, c1 = 0;
+  for (uint8_t row = SPRITE_CROP; row < spriteSize; ++row) {
+    for (uint8_t col = SPRITE_CROP; col < spriteSize; ++col) {
+      if (readGraphicPixel(from, row, col) != readGraphicPixel(to, row, col)) {
+        if (row < r0) { r0 = row; }
+        r1 = row;
+        if (col < c0) { c0 = col; }
+        if (col > c1) { c1 = col; }
+      }
+    }
+  }
+  if (r0 == 0xFF) { return; }
+
+  lcdSetWindow(x0 + c0 - SPRITE_CROP, y0 + r0 - SPRITE_CROP, x0 + c1 - SPRITE_CROP, y0 + r1 - SPRITE_CROP);
+  spiWriteSpriteRect(to, r0, r1, c0, c1);
+}
+
+// starts an animation on a cell after a delay (ms)
+// returns false if every slot is busy, the cell then just shows its final state
+bool animStart(const animation *anim, uint8_t x, uint8_t y, uint16_t delay) {
+  // one animation per tile, a second one couldn't tell what the first left on screen
+  if (grid[x][y] & CELL_ANIMATING) { return false; }
+  for (uint8_t k = 0; k < MAX_ANIMATIONS; ++k) {
+    if (animSlots[k].anim == NULL) {
+      animSlots[k].anim = anim;
+      animSlots[k].x = x;
+      animSlots[k].y = y;
+      animSlots[k].frame = 0;
+      animSlots[k].nextTime = sysTime + delay;
+      boardWriteBegin();
+      grid[x][y] |= CELL_ANIMATING;
+      boardWriteEnd();
+      return true;
+    }
+  }
+  return false;
+}
+
+// shows the cells held back by a cascade, ring by ring around (x, y)
+void animCascade(uint8_t x, uint8_t y) {
+  // a new cascade releases whatever is left of the previous one
+  if (cascadeRing != 0) {
+    boardWriteBegin();
+    for (uint8_t i = 0; i < boardRows; ++i) {
+      drawPending[i] |= heldCells[i];
+      heldCells[i] = 0;
+    }
+    boardWriteEnd();
+  }
+  cascadeX = x;
+  cascadeY = y;
+  cascadeRing = 1;
+  cascadeNext = sysTime + CASCADE_STEP;
+}
+
+// true while any animation, cascade or sweep is still running
+bool animBusy() {
+  if (cascadeRing != 0 || sweepCol != 0xFF) { return true; }
+  for (uint8_t k = 0; k < MAX_ANIMATIONS; ++k) {
+    if (animSlots[k].anim != NULL) { return true; }
+  }
+  return false;
+}
+
+// advances every animation whose frame time has come, at most one frame each per call
+// called from LCD_Tick so animations are paced by time and never hold up input
+void animStep() {
+  for (uint8_t k = 0; k < MAX_ANIMATIONS; ++k) {
+    animSlot *a = &animSlots[k];
+    if (a->anim == NULL || (int16_t)(sysTime - a->nextTime) < 0) { continue; }
+
+    lcdCoord x0 = boardX0 + cellPitch * a->x;
+    lcdCoord y0 = boardY0 + cellPitch * a->y;
+    uint8_t frames = pgm_read_byte(&a->anim->numFrames);
+    // the first frame goes over whatever drawScreen() left on the tile
+    uint8_t shown = (a->frame == 0) ? drawnSprite(drawn[a->x][a->y]) :
+                    pgm_read_byte(&a->anim->frames[a->frame - 1]);
+    if (a->frame < frames) {
+      uint8_t g = pgm_read_byte(&a->anim->frames[a->frame]);
+      drawSquareDelta(x0, y0, shown, g);
+      a->frame++;
+      a->nextTime += pgm_read_byte(&a->anim->frameTime);
+    }
+    else {
+      // done, put the cell's own sprite back, a held one is redrawn whole once the cascade gets there
+      boardWriteBegin();
+      grid[a->x][a->y] &= ~CELL_ANIMATING;
+      uint8_t look = grid[a->x][a->y];
+      boardWriteEnd();
+      if ((heldCells[a->x] >> a->y) & 1) { drawn[a->x][a->y] = DRAWN_NONE; }
+      else {
+        drawSquareDelta(x0, y0, shown, cellSprite(look));
+        drawn[a->x][a->y] = look;
+      }
+      a->anim = NULL;
+    }
+  }
+
+  if (cascadeRing != 0 && (int16_t)(sysTime - cascadeNext) >= 0) {
+    bool more = false;
+    boardWriteBegin();
+    for (uint8_t i = 0; i < boardRows; ++i) {
+      uint8_t dx = (i > cascadeX) ? i - cascadeX : cascadeX - i;
+      for (uint8_t j = 0; j < boardCols && dx <= cascadeRing; ++j) {
+        uint8_t dy = (j > cascadeY) ? j - cascadeY : cascadeY - j;
+        if (dy <= cascadeRing && ((heldCells[i] >> j) & 1)) {
+          heldCells[i] &= ~(1U << j);
+          drawPending[i] |= 1U << j;
+        }
+      }
+      if (heldCells[i]) { more = true; }
+    }
+    boardWriteEnd();
+    cascadeRing = more ? cascadeRing + 1 : 0;
+    cascadeNext += CASCADE_STEP;
+  }
+
+  if (sweepCol != 0xFF && (int16_t)(sysTime - sweepNext) >= 0) {
+    for (uint8_t j = 0; j < boardCols; ++j) { animStart(&sweepAnim, sweepCol, j, 0); }
+    sweepCol = (sweepCol + 1 < boardRows) ? sweepCol + 1 : 0xFF;
+    sweepNext += SWEEP_STEP;
+  }
+}
+
+// starts the win sweep across the board
+void animSweep() {
+  sweepCol = 0;
+  sweepNext = sysTime;
+}
+
+// sprite id for a cell's look byte, from cellSprites
+uint8_t cellSprite(uint8_t look) {
+    return pgm_read_byte(&cellSprites.id[look & (CELL_LOOKS - 1)]);
+}
+
+// sprite id on screen for a drawn[] byte, SPRITE_NONE = nothing drawn yet
+uint8_t drawnSprite(uint8_t look) {
+    return (look == DRAWN_NONE) ? SPRITE_NONE : cellSprite(look);
+}
+
+// brings one cell on screen up to date with the board, returns true if anything was sent
+bool drawCell(uint8_t i, uint8_t j) {
+    // animations and cascades own these tiles for now
+    uint8_t look = grid[i][j];
+    if ((look & CELL_ANIMATING) || ((heldCells[i] >> j) & 1)) { return false; }
+
+    // only send tiles whose look changed, and of those only the ones whose sprite did
+    uint8_t was = drawn[i][j];
+    if (look == was) { return false; }
+    drawn[i][j] = look;
+    uint8_t from = drawnSprite(was);
+    uint8_t to = cellSprite(look);
+    if (from == to) { return false; }
+    drawSquareDelta(boardX0 + cellPitch * i, boardY0 + cellPitch * j, from, to);
+    return true;
+}
+
+// draws the cells committed transactions changed, within the LCD_BUDGET_US left since frameStart()
+// only draws between board writes, so a frame never mixes two board states
+// the cells the cursor left and moved to go first, the rest stay pending for the next tick
+// cells an animation or cascade holds are dropped, it hands them back once it's done
+void drawScreen() {
+    // no write runs while the board is drawn, so it is at least as new as every cell taken here
+    bool any = false;
+    for (uint8_t i = 0; i < MAX_ROWS; ++i) {
+        drawPending[i] |= boardDirty[i];
+        boardDirty[i] = 0;
+        if (drawPending[i]) { any = true; }
+    }
+    // the cells stay pending while a write section is open
+    if (!any || !boardStable()) { return; }
+
+    drawCell(drawCursorX, drawCursorY);
+    drawCell(gridX, gridY);
+    drawPending[drawCursorX] &= ~(1U << drawCursorY);
+    drawPending[gridX] &= ~(1U << gridY);
+    drawCursorX = gridX;
+    drawCursorY = gridY;
+
+    for (uint8_t i = 0; i < boardRows; ++i) {
+        uint16_t line = drawPending[i] & lineMask;
+        for (uint8_t j = 0; line; ++j, line >>= 1) {
+            if (!(line & 1)) { continue; }
+            if (frameElapsed() >= LCD_BUDGET_US) { return; }
+            drawCell(i, j);
+            drawPending[i] &= ~(1U << j);
+        }
+    }
+}
+
+// a fill in progress, see fillStep()
+coPoint fillCo = CO_DONE;
+lcdCoord fillX0, fillY0, fillX1, fillY1;
+uint16_t fillColor;
+uint32_t fillPairs; // pixel pairs left to send
+
+// starts filling a rectangle with a color, fillStep() sends it
+void fillStart(lcdCoord x0, lcdCoord y0, lcdCoord x1, lcdCoord y1, uint16_t color) {
+  fillX0 = x0;
+  fillY0 = y0;
+  fillX1 = x1;
+  fillY1 = y1;
+  fillColor = color;
+  fillCo = 0;
+}
+
+// fills the visible part of the panel with a palette color, nothing drawn before is left on it
+void fillScreen(uint8_t color) {
+  screenColor = color;
+  drawInvalidate();
+  for (uint8_t k = 0; k < 3 * HUD_DIGITS; ++k) { hudShown[k] = 0xFF; }
+  fillStart(SCREEN_X0, SCREEN_Y0, SCREEN_X0 + SCREEN_WIDTH - 1, SCREEN_Y0 + SCREEN_HEIGHT - 1,
+            pgm_read_word(&paletteColors[color]));
+}
+
+// sends the fill until the LCD_BUDGET_US since frameStart() runs out, true once it's done
+// (or when there is none), the window stays open in between, so nothing else may be sent
+// to the LCD until then: a full screen is 32 KB on the ST7735, far more than one tick
+bool fillStep() {
+  CO_BEGIN(fillCo);
+  lcdSetWindow(fillX0, fillY0, fillX1, fillY1);
+
+  // Write pixels two at a time, an odd count wraps one extra pixel of the same color
+  fillPairs = ((uint32_t)(fillX1 - fillX0 + 1) * (fillY1 - fillY0 + 1) + 1) / 2;
+  while (fillPairs > 0) {
+    spiWritePixels(fillColor, fillColor);
+    // the budget is checked every 16 pairs, which overshoots it by a couple hundred us at most
+    if ((--fillPairs & 15) == 0 && frameElapsed() >= LCD_BUDGET_US) { CO_YIELD(fillCo); }
+  }
+  CO_END(fillCo);
+}
+
+// display power state, see LCD_IDLE_MS
+bool lcdIdle = false; // the panel is in idle and partial mode
+uint8_t lcdInputSeen = 0; // inputEvents as of the last check
+uint16_t lcdQuietSince = 0; // sysTime of the last input or animation
+
+// switches the panel between normal and its idle and partial modes
+void lcdPower(bool idle) {
+  if (idle == lcdIdle) { return; }
+  lcdIdle = idle;
+  if (!idle) {
+    spiWriteCommand(NORON);
+    spiWriteCommand(IDMOFF);
+    return;
+  }
+
+  // the lines under the HUD and the board, which way they run depends on the panel
+  uint16_t first = Display::partialColumns ? boardX0 : boardY0 - HUD_HEIGHT;
+  uint16_t last = Display::partialColumns ? boardX0 + boardRows * cellPitch - 1 : boardY0 + boardCols * cellPitch - 1;
+  spiWriteCommand(PTLAR);
+  spiWriteData(first >> 8);
+  spiWriteData(first & 0xFF);
+  spiWriteData(last >> 8);
+  spiWriteData(last & 0xFF);
+  spiWriteCommand(PTLON);
+  spiWriteCommand(IDMON);
+}
+
+// powers the panel down once input and animations have been quiet for LCD_IDLE_MS, and back
+// up on the next input event or new board, call it every LCD tick once the panel is up and no
+// fill is open, a new board may have another size, so PTLAR is set again on the way back down
+// once idle it stays idle however long, sysTime wrapping around can't wake it
+void lcdActivity() {
+  if (LCD_IDLE_MS == 0) { return; }
+  if (inputEvents != lcdInputSeen || lcdNewBoard || animBusy()) {
+    lcdInputSeen = inputEvents;
+    lcdNewBoard = false;
+    lcdQuietSince = sysTime;
+    lcdPower(false);
+  }
+  else if (!lcdIdle && (uint16_t)(sysTime - lcdQuietSince) >= LCD_IDLE_MS) {
+    lcdPower(true);
+  }
+}
+
+#ifdef COMMAND_MODE
+// a screenshot being sent, see shotStep()
+lcdCoord shotX, shotY; // next pixel
+uint8_t shotColor; // color of the run so far
+uint8_t shotLength; // pixels in it
+uint8_t shotNext; // pixel that ended it
+uint8_t shotHud[3 * HUD_DIGITS]; // the HUD as it was when the screenshot started
+
+// starts sending a screenshot
+void shotStart() {
+  for (uint8_t k = 0; k < 3 * HUD_DIGITS; ++k) { shotHud[k] = hudShown[k]; }
+  shotCo = 0;
+}
+
+// sprite on screen at board cell (i, j), SPRITE_NONE = nothing drawn there
+uint8_t shotSprite(uint8_t i, uint8_t j) {
+  // an animation shows the frame it drew last, or the tile it started from
+  for (uint8_t k = 0; k < MAX_ANIMATIONS; ++k) {
+    const animSlot *a = &animSlots[k];
+    if (a->anim != NULL && a->x == i && a->y == j && a->frame > 0) {
+      return pgm_read_byte(&a->anim->frames[a->frame - 1]);
+    }
+  }
+  return drawnSprite(drawn[i][j]);
+}
+
+// palette color of a panel pixel, worked out from what the renderer drew there: the board
+// tiles in drawn[] and running animations, the HUD digits, and the last full screen fill
+uint8_t shotPixel(lcdCoord x, lcdCoord y) {
+  if (x >= boardX0 && x < boardX0 + boardRows * cellPitch && y >= boardY0 && y < boardY0 + boardCols * cellPitch) {
+    uint8_t id = shotSprite((x - boardX0) / cellPitch, (y - boardY0) / cellPitch);
+    if (id == SPRITE_NONE) { return screenColor; }
+    return readGraphicPixel(id, SPRITE_CROP + (y - boardY0) % cellPitch, SPRITE_CROP + (x - boardX0) % cellPitch);
+  }
+
+  lcdCoord hudY = boardY0 - HUD_HEIGHT;
+  if (y >= hudY && y < boardY0) {
+    for (uint8_t c = 0; c < 3; ++c) {
+      lcdCoord x0 = hudCounterX(c);
+      if (x < x0 || x >= x0 + HUD_DIGITS * HUD_GLYPH_WIDTH) { continue; }
+      uint8_t digit = shotHud[c * HUD_DIGITS + (x - x0) / HUD_GLYPH_WIDTH];
+      if (digit == 0xFF) { return screenColor; }
+      uint8_t col = (x - x0) % HUD_GLYPH_WIDTH;
+      uint8_t bits = (col < 5) ? pgm_read_byte(&hudFont[digit][col]) : 0;
+      return ((bits >> (y - hudY)) & 1) ? hudColor(c) : PAL_BLACK;
+    }
+  }
+  return screenColor;
+}
+
+// sends the screenshot shotStart() asked for, true once it's out (or when there is none)
+// there is no frame buffer, every pixel is rebuilt from the board and the sprite tables,
+// so the runs are worked out as the TX buffer frees up, at most a buffer's worth per call
+// to keep Game_Tick short, the board can change in between but nothing moves without input
+bool shotStep() {
+  uint8_t budget = UART_TX_SIZE;
+  CO_BEGIN(shotCo);
+  CO_WAIT_UNTIL(shotCo, uart_tx_free() >= SHOT_HEADER);
+  uart_send(LINK_HEADER(CMD_SHOT, 0));
+  uart_send(SCREEN_WIDTH >> 8);
+  uart_send(SCREEN_WIDTH & 0xFF);
+  uart_send(SCREEN_HEIGHT >> 8);
+  uart_send(SCREEN_HEIGHT & 0xFF);
+  for (uint8_t k = 0; k < PALETTE_SIZE; ++k) {
+    uint16_t color = pgm_read_word(&paletteColors[k]);
+    uart_send(color >> 8);
+    uart_send(color & 0xFF);
+  }
+
+  shotLength = 0;
+  for (shotY = 0; shotY < SCREEN_HEIGHT; ++shotY) {
+    for (shotX = 0; shotX < SCREEN_WIDTH; ++shotX) {
+      shotNext = shotPixel(SCREEN_X0 + shotX, SCREEN_Y0 + shotY);
+      if (shotLength > 0 && (shotNext != shotColor || shotLength == SHOT_RUN_MAX)) {
+        CO_WAIT_UNTIL(shotCo, budget > 0 && uart_send((shotLength - 1) << 3 | shotColor));
+        budget--;
+        shotLength = 0;
+      }
+      if (shotLength == 0) { shotColor = shotNext; }
+      shotLength++;
+    }
+  }
+  CO_WAIT_UNTIL(shotCo, uart_send((shotLength - 1) << 3 | shotColor));
+  CO_END(shotCo);
+}
+#endif
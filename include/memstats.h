@@ -0,0 +1,53 @@
+#ifndef MEMSTATS_H
+#define MEMSTATS_H
+
+#include <avr/io.h>
+#include <stdint.h>
+
+// stack high-water mark: the free RAM between the end of .bss and the stack is
+// painted at boot, and whatever is still painted later was never touched by the stack
+// (this assumes no malloc, the heap would start at _end too)
+
+#define STACK_PAINT 0xC5
+
+extern uint8_t __data_start; // start of static RAM, set by the linker
+extern uint8_t _end; // end of .bss
+extern uint8_t __stack; // top of RAM
+
+// runs from .init1, before main(), so it's written in assembly: the C runtime hasn't set up
+// r1 = 0 or the stack pointer yet (that happens in .init2), so C code could neither rely on
+// them nor use a frame, the loop paints _end up to and including __stack
+// it has no ret, a .initN section falls through into the next one
+// (host builds of the firmware, test/host/, leave it out)
+#define STACK_PAINT_STR2(x) #x
+#define STACK_PAINT_STR(x) STACK_PAINT_STR2(x)
+#ifdef __AVR__
+void stackPaint(void) __attribute__((naked, used, section(".init1")));
+void stackPaint(void) {
+    asm volatile(
+        "    ldi r30, lo8(_end)\n"
+        "    ldi r31, hi8(_end)\n"
+        "    ldi r24, " STACK_PAINT_STR(STACK_PAINT) "\n"
+        "    ldi r25, hi8(__stack)\n"
+        "    rjmp 2f\n"
+        "1:  st Z+, r24\n"
+        "2:  cpi r30, lo8(__stack)\n"
+        "    cpc r31, r25\n"
+        "    brlo 1b\n"
+        "    breq 1b\n");
+}
+#endif
+
+// bytes of static RAM (.data + .bss)
+uint16_t ramStatic() {
+    return &_end - &__data_start;
+}
+
+// bytes the stack has never reached since boot, the worst-case headroom
+uint16_t stackHeadroom() {
+    const uint8_t *p = &_end;
+    while (p <= &__stack && *p == STACK_PAINT) { p++; }
+    return p - &_end;
+}
+
+#endif /* MEMSTATS_H */
@@ -0,0 +1,181 @@
+#include <avr/eeprom.h>
+#include <stdint.h>
+#include "serialATmega.h"
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+// input sources for Joystick_Tick
+#define INPUT_LIVE 0 // read the joystick
+#define INPUT_RECORD 1 // read the joystick and record the session to EEPROM
+#define INPUT_REPLAY 2 // feed the recorded session back in place of the joystick
+
+// pick the input source at build time
+#ifndef INPUT_MODE
+#define INPUT_MODE INPUT_LIVE
+#endif
+
+// one joystick sample packed into a byte
+// zones: 0 = left/up, 1 = center, 2 = right/down
+#define INPUT_PACK(x, y, press) ((x) | ((y) << 2) | ((press) << 4))
+#define INPUT_X(in) ((in) & 0x03)
+#define INPUT_Y(in) (((in) >> 2) & 0x03)
+#define INPUT_PRESS(in) (((in) >> 4) & 0x01)
+#define INPUT_IDLE INPUT_PACK(1, 1, 0)
+
+// a recorded event: the sample that became active after some joystick ticks
+// only changes are stored, long presses are rebuilt from how long the press bit stays set
+typedef struct _inputEvent {
+    uint8_t ticks;
+    uint8_t input;
+} inputEvent;
+
+// EEPROM layout: magic, board seed, event count, events
+#define REPLAY_MAGIC 0xA5
+#define REPLAY_MAX_EVENTS ((E2END + 1 - 5) / sizeof(inputEvent))
+
+uint8_t EEMEM replayMagic;
+uint16_t EEMEM replaySeed;
+uint16_t EEMEM replayCount;
+inputEvent EEMEM replayEvents[REPLAY_MAX_EVENTS];
+
+// recording / playback state
+uint16_t replayNumEvents = 0; // events recorded or left to play back
+uint16_t replayPos = 0; // next event to record or play back
+uint8_t replayTicks = 0; // joystick ticks since the last event
+uint8_t replayPrevInput = INPUT_IDLE;
+bool replayFinished = false;
+
+// EEPROM writes take ~3.3 ms each, so they are queued and flushed one byte per scheduler tick
+// an event is two bytes per joystick tick at most, so the queue drains faster than it fills
+// only recording writes, the other modes keep a single slot, which always reads as full
+#if INPUT_MODE == INPUT_RECORD
+#define REPLAY_QUEUE_SIZE 32 // must be a power of two
+#else
+#define REPLAY_QUEUE_SIZE 1
+#endif
+#define REPLAY_EVENT_BYTES 2
+#define REPLAY_FINISH_BYTES 2 // room always kept for the final event count
+uint8_t *replayQueueAddr[REPLAY_QUEUE_SIZE];
+uint8_t replayQueueData[REPLAY_QUEUE_SIZE];
+uint8_t replayQueueHead = 0;
+uint8_t replayQueueTail = 0;
+
+// free slots in the write queue
+uint8_t replayQueueFree() {
+    return (replayQueueTail - replayQueueHead - 1) & (REPLAY_QUEUE_SIZE - 1);
+}
+
+// queues one EEPROM byte write, callers check replayQueueFree() first
+void replayQueueByte(uint8_t *addr, uint8_t data) {
+    uint8_t next = (replayQueueHead + 1) & (REPLAY_QUEUE_SIZE - 1);
+    if (next == replayQueueTail) { return; }
+    replayQueueAddr[replayQueueHead] = addr;
+    replayQueueData[replayQueueHead] = data;
+    replayQueueHead = next;
+}
+
+void replayQueueWord(uint16_t *addr, uint16_t data) {
+    replayQueueByte((uint8_t*)addr, data & 0xFF);
+    replayQueueByte((uint8_t*)addr + 1, data >> 8);
+}
+
+// writes one queued byte if the EEPROM is not busy, never waits, call once per scheduler tick
+void replayFlush() {
+    if (replayQueueTail == replayQueueHead || !eeprom_is_ready()) { return; }
+    eeprom_update_byte(replayQueueAddr[replayQueueTail], replayQueueData[replayQueueTail]);
+    replayQueueTail = (replayQueueTail + 1) & (REPLAY_QUEUE_SIZE - 1);
+}
+
+// sends the recorded session over serial: seed, event count, then ticks/input pairs
+void replayDump() {
+    uint16_t count = eeprom_read_word(&replayCount);
+    serial_println("Replay:");
+    serial_println(eeprom_read_word(&replaySeed), 16);
+    serial_println(count);
+    for (uint16_t i = 0; i < count && i < REPLAY_MAX_EVENTS; ++i) {
+        serial_println(eeprom_read_byte(&replayEvents[i].ticks));
+        serial_println(eeprom_read_byte(&replayEvents[i].input), 16);
+    }
+}
+
+// starts recording or playback, call before generating the board
+// returns the board seed to use: the recorded one when replaying
+uint16_t replayStart(uint16_t seed) {
+    replayPos = 0;
+    replayTicks = 0;
+    replayPrevInput = INPUT_IDLE;
+    replayFinished = false;
+
+#if INPUT_MODE == INPUT_RECORD
+    replayNumEvents = 0;
+    replayQueueByte(&replayMagic, REPLAY_MAGIC);
+    replayQueueWord(&replaySeed, seed);
+    replayQueueWord(&replayCount, 0);
+#elif INPUT_MODE == INPUT_REPLAY
+    if (eeprom_read_byte(&replayMagic) == REPLAY_MAGIC) {
+        seed = eeprom_read_word(&replaySeed);
+        replayNumEvents = eeprom_read_word(&replayCount);
+    }
+    else { replayNumEvents = 0; }
+#endif
+
+    return seed;
+}
+
+// stops recording, the session is dumped over serial once it is fully written
+// the count only covers events that were queued whole
+void replayFinish() {
+#if INPUT_MODE == INPUT_RECORD
+    if (!replayFinished) {
+        replayQueueWord(&replayCount, replayNumEvents);
+        replayFinished = true;
+    }
+#endif
+}
+
+// call once per joystick tick with the live sample
+// returns the sample the game should act on
+uint8_t replayInput(uint8_t input) {
+#if INPUT_MODE == INPUT_RECORD
+    static bool dumped = false;
+
+    if (replayFinished) {
+        if (!dumped && replayQueueTail == replayQueueHead) {
+            replayDump();
+            dumped = true;
+        }
+        return input;
+    }
+    dumped = false;
+
+    // store changes, or a repeat when the tick count would overflow
+    if (replayTicks < 0xFF) { replayTicks++; }
+    if ((input != replayPrevInput || replayTicks == 0xFF) && replayPos < REPLAY_MAX_EVENTS) {
+        // the EEPROM fell behind: end the recording here rather than leave a hole in it
+        if (replayQueueFree() < REPLAY_EVENT_BYTES + REPLAY_FINISH_BYTES) {
+            replayFinish();
+            return input;
+        }
+        replayQueueByte(&replayEvents[replayPos].ticks, replayTicks);
+        replayQueueByte(&replayEvents[replayPos].input, input);
+        replayPos++;
+        replayNumEvents = replayPos;
+        replayTicks = 0;
+        replayPrevInput = input;
+    }
+    return input;
+#elif INPUT_MODE == INPUT_REPLAY
+    if (replayTicks < 0xFF) { replayTicks++; }
+    if (replayPos < replayNumEvents && replayTicks >= eeprom_read_byte(&replayEvents[replayPos].ticks)) {
+        replayPrevInput = eeprom_read_byte(&replayEvents[replayPos].input);
+        replayPos++;
+        replayTicks = 0;
+    }
+    return replayPrevInput;
+#else
+    return input;
+#endif
+}
+
+#endif /* REPLAY_H */
@@ -24,7 +24,7 @@ void serial_char(char ch )
 
 //sends a string
 void serial_println(char *str){
-    for (int i; str[i] != '\0'; i++){
+    for (int i = 0; str[i] != '\0'; i++){
         serial_char(str[i]);
     }
     serial_char('\n');
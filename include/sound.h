@@ -0,0 +1,118 @@
+#ifndef SOUND_H
+#define SOUND_H
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+// sound effects on the buzzer (PD6 = OC0A), Timer0 in CTC mode toggles the pin in hardware
+// the compare ISR counts the toggles and moves on to the next note by itself,
+// so playing a sound is just queueing it, no task ever waits on the buzzer
+
+// Timer0 can only toggle OC0A, so the buzzer can't move off PD6
+#define BUZZER PD6
+
+#define SOUND_QUEUE_SIZE 4 // must be a power of two
+
+// a note: Timer0 clock select, compare value, and how many compare matches it lasts
+// the pin toggles on every match, so a note of f Hz matches 2 * f times a second
+typedef struct _soundNote {
+    uint8_t clock; // TCCR0B clock bits, SOUND_REST set = pin stays quiet
+    uint8_t ocr;
+    uint16_t matches; // 0 ends the effect
+} soundNote;
+
+#define SOUND_REST 0x80
+#define SOUND_DIV64 0x03
+#define SOUND_DIV256 0x04
+
+// notes from 125 Hz up, the prescaler is picked so the compare value fits in 8 bits
+#define SOUND_PRESCALE(hz) ((hz) >= 500 ? 64UL : 256UL)
+#define NOTE(hz, ms) { (hz) >= 500 ? SOUND_DIV64 : SOUND_DIV256, \
+    (uint8_t)(F_CPU / (2UL * SOUND_PRESCALE(hz) * (hz)) - 1), (uint16_t)(2UL * (hz) * (ms) / 1000) }
+// silence, timed by a 500 Hz match rate
+#define REST(ms) { SOUND_REST | SOUND_DIV256, (uint8_t)(F_CPU / (256UL * 500) - 1), (uint16_t)(500UL * (ms) / 1000) }
+#define SOUND_END { 0, 0, 0 }
+
+const soundNote PROGMEM soundReveal[] = { NOTE(1760, 20), SOUND_END };
+const soundNote PROGMEM soundFlag[] = { NOTE(1319, 30), NOTE(1760, 30), SOUND_END };
+const soundNote PROGMEM soundExplosion[] = {
+    NOTE(220, 80), NOTE(180, 80), NOTE(150, 120), NOTE(125, 250), SOUND_END
+};
+const soundNote PROGMEM soundWin[] = {
+    NOTE(1047, 80), NOTE(1319, 80), NOTE(1568, 80), REST(40), NOTE(2093, 250), SOUND_END
+};
+
+// effects waiting to play, filled by soundPlay(), drained by the ISR
+const soundNote *soundQueue[SOUND_QUEUE_SIZE];
+volatile uint8_t soundQueueHead = 0; // written by soundPlay()
+volatile uint8_t soundQueueTail = 0; // written by the ISR
+const soundNote *soundNext = NULL; // next note of the effect playing, NULL = idle (ISR only, once started)
+volatile uint16_t soundLeft = 0; // compare matches left in the note playing
+
+void soundInit() {
+    DDRD |= (1 << BUZZER);
+    PORTD &= ~(1 << BUZZER);
+    TCCR0A = (1 << WGM01); // CTC, pin disconnected until a note plays
+    TCCR0B = 0;
+    TIMSK0 = (1 << OCIE0A);
+}
+
+// loads the next note, or the next queued effect, stops the timer when there is nothing left
+// called with interrupts off
+void soundAdvance() {
+    while (true) {
+        if (soundNext != NULL) {
+            uint16_t matches = pgm_read_word(&soundNext->matches);
+            if (matches != 0) {
+                uint8_t clock = pgm_read_byte(&soundNext->clock);
+                OCR0A = pgm_read_byte(&soundNext->ocr);
+                TCNT0 = 0;
+                if (clock & SOUND_REST) {
+                    TCCR0A = (1 << WGM01);
+                    PORTD &= ~(1 << BUZZER);
+                }
+                else { TCCR0A = (1 << COM0A0) | (1 << WGM01); }
+                TCCR0B = clock & 0x07;
+                soundLeft = matches;
+                soundNext++;
+                return;
+            }
+            soundNext = NULL;
+        }
+        if (soundQueueTail == soundQueueHead) { break; }
+        soundNext = soundQueue[soundQueueTail];
+        soundQueueTail = (soundQueueTail + 1) & (SOUND_QUEUE_SIZE - 1);
+    }
+
+    // idle: stop the clock and leave the pin low
+    TCCR0B = 0;
+    TCCR0A = (1 << WGM01);
+    PORTD &= ~(1 << BUZZER);
+}
+
+// queues an effect (PROGMEM, ends with SOUND_END), dropped if the queue is full
+void soundPlay(const soundNote *effect) {
+    uint8_t sreg = SREG;
+    cli();
+    uint8_t next = (soundQueueHead + 1) & (SOUND_QUEUE_SIZE - 1);
+    if (next != soundQueueTail) {
+        soundQueue[soundQueueHead] = effect;
+        soundQueueHead = next;
+        // nothing playing means no ISR to pick it up, start it here
+        if (TCCR0B == 0) { soundAdvance(); }
+    }
+    SREG = sreg;
+}
+
+ISR(TIMER0_COMPA_vect)
+{
+    if (--soundLeft == 0) { soundAdvance(); }
+}
+
+#endif /* SOUND_H */
@@ -73,6 +73,9 @@ void TimerOff() {
 ISR(TIMER2_COMPA_vect)
 {
 	// CPU automatically calls when TCNT0 == OCR0 (every 1 ms per TimerOn settings)
+	// TimerISR() runs with interrupts on, meanwhile the count sits at 0: the ms that go by
+	// are left to it, it times itself on Timer1 and catches up
+	if (_avr_timer_cntcurr == 0) { return; }
 	_avr_timer_cntcurr--; 			// Count down to 0 rather than up to TOP
 	if (_avr_timer_cntcurr == 0) { 	// results in a more efficient compare
 		TimerISR(); 				// Call the ISR that the user uses
@@ -0,0 +1,86 @@
+#ifndef UART_H
+#define UART_H
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+
+// interrupt driven UART, received bytes and bytes to send go through ring buffers
+// so neither side ever waits on the line
+// don't mix with the blocking serial_char()/serial_println() while the TX buffer is in use
+// only built for the modes that use it, the buffers take 128 bytes of SRAM and the ISRs would
+// take over the port from serial_println()
+#if defined(VERSUS_MODE) || defined(COMMAND_MODE) || defined(LCD_CAPTURE)
+
+#define UART_RX_SIZE 64 // must be a power of two
+#define UART_TX_SIZE 64 // must be a power of two
+
+volatile uint8_t uartRxBuf[UART_RX_SIZE];
+volatile uint8_t uartRxHead = 0; // written by the RX ISR
+volatile uint8_t uartRxTail = 0; // written by the reader
+volatile uint8_t uartRxDropped = 0; // bytes lost to a full buffer
+
+volatile uint8_t uartTxBuf[UART_TX_SIZE];
+volatile uint8_t uartTxHead = 0; // written by the sender
+volatile uint8_t uartTxTail = 0; // written by the UDRE ISR
+
+// like serial_init(), but keeps the RX interrupt on
+void uart_init(unsigned long baud) {
+    UBRR0 = (16000000UL / (baud * 16UL)) - 1; // Set baud rate
+    UCSR0B = (1 << TXEN0) | (1 << RXEN0) | (1 << RXCIE0);
+    UCSR0C = (3 << UCSZ00);
+}
+
+// queues a byte to send, returns false if the TX buffer is full
+bool uart_send(uint8_t data) {
+    uint8_t next = (uartTxHead + 1) & (UART_TX_SIZE - 1);
+    if (next == uartTxTail) { return false; }
+    uartTxBuf[uartTxHead] = data;
+    uartTxHead = next;
+    UCSR0B |= (1 << UDRIE0); // the ISR sends it once the data register is free
+    return true;
+}
+
+// free space in the TX buffer
+uint8_t uart_tx_free() {
+    return (uartTxTail - uartTxHead - 1) & (UART_TX_SIZE - 1);
+}
+
+// bytes waiting to be read
+uint8_t uart_available() {
+    return (uartRxHead - uartRxTail) & (UART_RX_SIZE - 1);
+}
+
+// next received byte, or -1 if there is none
+int16_t uart_read() {
+    if (uartRxHead == uartRxTail) { return -1; }
+    uint8_t data = uartRxBuf[uartRxTail];
+    uartRxTail = (uartRxTail + 1) & (UART_RX_SIZE - 1);
+    return data;
+}
+
+ISR(USART_RX_vect)
+{
+    uint8_t data = UDR0;
+    uint8_t next = (uartRxHead + 1) & (UART_RX_SIZE - 1);
+    if (next == uartRxTail) {
+        uartRxDropped++;
+        return;
+    }
+    uartRxBuf[uartRxHead] = data;
+    uartRxHead = next;
+}
+
+ISR(USART_UDRE_vect)
+{
+    if (uartTxHead == uartTxTail) {
+        UCSR0B &= ~(1 << UDRIE0); // nothing left, stop the interrupt
+        return;
+    }
+    UDR0 = uartTxBuf[uartTxTail];
+    uartTxTail = (uartTxTail + 1) & (UART_TX_SIZE - 1);
+}
+
+#endif
+
+#endif /* UART_H */
@@ -7,199 +7,452 @@
 #define F_CPU 16000000UL // 16 MHz
 #include <util/delay.h>
 #include "main.h"
-
-// Task struct for concurrent synchSMs implmentations (provided)
-typedef struct _task{
+#include "memstats.h"
+
+// compile-time task table for the concurrent synchSMs: a task is its tick function,
+// period (ms) and initial state, the scheduler works out the GCD period and each
+// task's period in GCD ticks at compile time and calls every tick function directly
+template <int (*TickFct)(int), unsigned long Period, int InitState>
+struct Task {
+  static const unsigned long period = Period;
   //Task's current state
-	signed char state;
-  // Task period
-	unsigned long period;
-  //Time elapsed since last task tick
-	unsigned long elapsedTime;
+  static int state;
+  //GCD ticks until the task ticks again, 0 = due now
+  static uint8_t ticksLeft;
   //Task tick function
-	int (*TickFct)(int); 		
-} task;
+  static inline int tick(int s) { return TickFct(s); }
+};
+
+template <int (*TickFct)(int), unsigned long Period, int InitState>
+int Task<TickFct, Period, InitState>::state = InitState;
 
-// task array size define
-#define NUM_TASKS 3
+template <int (*TickFct)(int), unsigned long Period, int InitState>
+uint8_t Task<TickFct, Period, InitState>::ticksLeft = 0;
+
+constexpr unsigned long gcdPeriod(unsigned long a, unsigned long b) {
+  return b == 0 ? a : gcdPeriod(b, a % b);
+}
+
+template <typename... Ts>
+struct PeriodGCD { static const unsigned long value = 0; };
+
+template <typename T, typename... Ts>
+struct PeriodGCD<T, Ts...> { static const unsigned long value = gcdPeriod(T::period, PeriodGCD<Ts...>::value); };
 
 // period definitions
 const unsigned long LCD_PERIOD = 20;
 const unsigned long JOYSTICK_PERIOD = 30;
 const unsigned long GAME_PERIOD = 50;
-const unsigned long GCD_PERIOD = 10;
+static_assert(LCD_BUDGET_US < LCD_PERIOD * 1000UL, "the render budget must leave time for the other tasks");
+
+// per-task tick counts and overruns (scheduler ticks missed because a tick ran past the GCD
+// period, charged to the task that ran longest in it), plus static RAM and stack headroom,
+// reported over serial about once a second
+// run with INPUT_REPLAY for a repeatable load, tools/ram_budget.sh gives the per-symbol RAM
+// #define TASK_STATS
+#if defined(TASK_STATS) && (defined(LCD_CAPTURE) || defined(VERSUS_MODE) || defined(COMMAND_MODE))
+#error "TASK_STATS prints with the blocking serial_println(), its bytes would land in the middle of what the UART mode sends"
+#endif
+#ifdef TASK_STATS
+// defined after the task list, which sizes them
+extern uint16_t taskTicks[];
+extern int8_t slowTask;
+extern uint16_t slowTime;
+#endif
+
+// ticks each task in turn, unrolled by the compiler
+template <unsigned long Gcd, int Index, typename... Ts>
+struct TaskRunner { static inline void run() { } };
+
+template <unsigned long Gcd, int Index, typename T, typename... Ts>
+struct TaskRunner<Gcd, Index, T, Ts...> {
+  static_assert(T::period % Gcd == 0, "task period must be a multiple of the GCD period");
+  static_assert(T::period / Gcd <= 255, "task period must fit in 8-bit GCD ticks");
+
+  static inline void run() {
+    // Check if the task is ready to tick
+    if (T::ticksLeft == 0) {
+#ifdef TASK_STATS
+      taskTicks[Index]++;
+      uint16_t began = TCNT1;
+#endif
+      // Tick and set the next state for this task
+      T::state = T::tick(T::state);
+#ifdef TASK_STATS
+      uint16_t took = TCNT1 - began;
+      if (took >= slowTime) {
+        slowTime = took;
+        slowTask = Index;
+      }
+#endif
+      T::ticksLeft = T::period / Gcd;
+    }
+    T::ticksLeft--;
+    TaskRunner<Gcd, Index + 1, Ts...>::run();
+  }
+};
 
-// task array
-task tasks[NUM_TASKS];
+template <typename... Ts>
+struct Scheduler {
+  static const unsigned long gcd = PeriodGCD<Ts...>::value;
+  static const uint8_t count = sizeof...(Ts);
+  static inline void run() { TaskRunner<gcd, 0, Ts...>::run(); }
+};
 
 // task enums
-enum LCD_States { LCD_Init, LCD_Display };
+enum LCD_States { LCD_Init, LCD_Config, LCD_Display, LCD_GameOver };
 enum Joystick_States { Joystick_Run };
 enum Game_States { Game_Run, Game_Lose, Game_Won };
 
 // task definitions
 int LCD_Tick(int state) {
+  frameStart();
+
+  // a screen fill has the LCD to itself until it's done, the render budget spreads it over ticks
+  if (!fillStep()) {
+    lcdCaptureFrame();
+    return state;
+  }
+
+  // the panel powers down while nothing happens on it
+  if (state >= LCD_Display) { lcdActivity(); }
+
   switch (state) {
     case LCD_Init:
-      // initialize the LCD
-      lcdInit();
+      // hardware reset, generate the board while reset is held low
+      PORTB &= ~(1 << LCD_RESET);
+      boardSeed = replayStart(boardSeed);
+      linkSeed = boardSeed;
       initGrid();
-      state = LCD_Display;
+      linkStart(linkSeed);
+      state = LCD_Config;
+      break;
+    case LCD_Config:
+      // the rest of the bring-up runs a step per tick, see lcdInit()
+      if (lcdInit()) { state = LCD_Display; }
       break;
     // within here, update depending on inputs from joystick, buttons, etc
     case LCD_Display:
-      if (gameLost) { fillRect(4, 4, 131, 131, RED); }
-      else {
-        // display something on the LCD
-        drawScreen();
+      // a new zoom level leaves the old board's tiles around the new one
+      if (boardResized) {
+        fillScreen(PAL_BLACK);
+        boardResized = false;
+        if (!fillStep()) { break; }
       }
 
+      // display something on the LCD, board cells only as far as the budget allows
+      drawScreen();
+      drawHud();
+      animStep();
+
+      // once the explosions are over, flood the screen red a single time
+      if (gameLost && !animBusy()) {
+        fillScreen(PAL_RED);
+        fillStep();
+        state = LCD_GameOver;
+        break;
+      }
+
+#ifdef LCD_STATS
+      // report SPI bytes per frame about once a second
+      static uint8_t statFrames = 0;
+      if (++statFrames >= 1000 / LCD_PERIOD) {
+        serial_println("LCD bytes/frame:");
+        serial_println(lcdBytes / statFrames);
+        serial_println("LCD windows/s:");
+        serial_println(lcdWindows);
+        lcdBytes = 0;
+        lcdWindows = 0;
+        statFrames = 0;
+      }
+#endif
+
 
       state = LCD_Display;
       break;
+    case LCD_GameOver:
+      // a new game was started, clear the red screen and draw it from scratch
+      if (!gameLost) {
+        fillScreen(PAL_BLACK);
+        fillStep();
+        state = LCD_Display;
+      }
+      break;
     default:
       break;
   }
+  lcdCaptureFrame();
   return state;
 }
 
 int Joystick_Tick(int state) {
 
-  static uint8_t prevGridX = 0;
-  static uint8_t prevGridY = 0;
   static uint8_t prevPress = 0;
   static uint16_t pressDurationCounter = 0;
   static bool longPressDetected = false;
   static uint8_t debounceCounter = 0;
-  static uint16_t x_filter = 512;
-  static uint16_t y_filter = 512;
-  uint8_t press = !GetBit(PINC,2);
 
   switch (state) {
-    case Joystick_Run:
+    case Joystick_Run: {
+      // 0=left/up, 1=center, 2=right/down
+      uint8_t x_zone = 1;
+      uint8_t y_zone = 1;
+      uint8_t press = 0;
+
+#if INPUT_MODE != INPUT_REPLAY
+      static uint16_t x_filter = 512;
+      static uint16_t y_filter = 512;
       uint16_t x_raw = ADC_read(JOYSTICK_VRX);
       uint16_t y_raw = ADC_read(JOYSTICK_VRY);
       
       x_filter = (x_filter * 3 + x_raw) / 4;
       y_filter = (y_filter * 3 + y_raw) / 4;
       
-
-      // 0=left/up, 1=dead, 2=center, 3=dead, 4=right/down
-      uint8_t x_zone = 2;
-      uint8_t y_zone = 2; 
-      
       if (x_filter < 300) {
         x_zone = 0;  // Left
       } else if (x_filter > 723) {
-        x_zone = 4;  // Right
+        x_zone = 2;  // Right
       }
       
       if (y_filter < 300) {
         y_zone = 0;  // Up
       } else if (y_filter > 723) {
-        y_zone = 4;  // Down
+        y_zone = 2;  // Down
       }
+
+      press = !GetBit(PINC,2);
+#endif
+
+      // record the sample, or swap in the recorded one when replaying
+      uint8_t input = replayInput(INPUT_PACK(x_zone, y_zone, press));
+      x_zone = INPUT_X(input);
+      y_zone = INPUT_Y(input);
+      press = INPUT_PRESS(input);
       
       if (debounceCounter > 0) {
         debounceCounter--;
       } else {
-        if (x_zone == 4 && gridX < 7) {
-          gridX++;
-          debounceCounter = 3; 
-        } else if (x_zone == 0 && gridX > 0) {
-          gridX--;
-          debounceCounter = 3;
-        }
-        
-        if (y_zone == 4 && gridY < 7) {
-          gridY++;
-          debounceCounter = 3;
-        } else if (y_zone == 0 && gridY > 0) {
-          gridY--;
+        // joystick zones 0/1/2 become a step of -1/0/+1
+        int8_t dx = (int8_t)x_zone - 1;
+        int8_t dy = (int8_t)y_zone - 1;
+        if (dx != 0 || dy != 0) {
+          eventPush(EVENT_MOVE, EVENT_MOVE_ARG(dx, dy));
           debounceCounter = 3;
         }
       }
 
-
-      grid[prevGridX][prevGridY].selected = false;
-      grid[gridX][gridY].selected = true;
-    
-
       if (press) {
         if (pressDurationCounter < 0xFFFF) {
             pressDurationCounter++;
         }
 
         if (pressDurationCounter >= 10 && !longPressDetected) {
-            if (!grid[gridX][gridY].revealed) {
-                grid[gridX][gridY].flagged = !grid[gridX][gridY].flagged;
-                serial_println("Long Press: Toggled Flag at (");
-                serial_println(gridX);
-                serial_println(", ");
-                serial_println(gridY);
-                serial_println(")");
-            }
+            eventPush(EVENT_LONG_PRESS, 0);
             longPressDetected = true;
         }
       } 
       else {
         if (prevPress && !longPressDetected) {
-            if (!grid[gridX][gridY].revealed && !grid[gridX][gridY].flagged) {
-              grid[gridX][gridY].revealed = true;
-            }
+            eventPush(EVENT_PRESS, 0);
         }
         pressDurationCounter = 0;
         longPressDetected = false;
-      
-        serial_println(gridX);
-        serial_println(gridY);
-        serial_println(press && !prevPress);
-
       }
 
+      prevPress = press;
       state = Joystick_Run; 
       break;
+    }
         default:
           break;
       }
-  prevPress = press;
-  prevGridX = gridX;
-  prevGridY = gridY;
   return state;
 }
 
 int Game_Tick(int state) {
-  static int numMines = 0;
+  static uint8_t secondTicks = 0;
+
+  // a new board is generated a pass per tick, input waits in its queues until the board is ready
+  if (!boardReady()) { return state; }
+
+  // apply whatever the opponent sent since the last tick
+  linkPoll();
+  // a seed from the opponent starts a new board
+  if (!boardReady()) { return state; }
+
+  // then the local input that queued up since the last tick, as one transaction
+  txnBegin();
+  gameEvent ev;
+  while (eventPop(&ev)) { eventApply(ev); }
+
+#ifdef COMMAND_MODE
+  // and the commands received, in rounds as the event queue frees up
+  // a batch is bounded by the RX buffer and the sender waits for CMD_DUMP, so this ends
+  // a screenshot goes out a TX buffer per tick, a dump as fast as TimerISR() can send it,
+  // the commands after either wait for it
+  while (shotStep() && dumpCo == CO_DONE && uart_available()) {
+    commandPoll();
+    while (eventPop(&ev)) { eventApply(ev); }
+  }
+#endif
+  // the renderer gets every cell it changed at once, the game its state transitions
+  const boardTxn *t = txnCommit();
 
+  // a new game replaces whatever ended the last one
+  if (t->events & TXN_NEW_GAME) { state = Game_Run; }
 
   switch (state) {
     case Game_Run:
-      if (gameLost) { state = Game_Lose; }
+      // game timer for the HUD
+      if (++secondTicks >= 1000 / GAME_PERIOD) {
+        secondTicks = 0;
+        gameSeconds++;
+      }
+      if (t->events & TXN_LOST) {
+        // end of the session, write out the recording
+        replayFinish();
+        linkSend(LINK_STATE, 1, 0);
+        state = Game_Lose;
+      }
+      else if (t->events & TXN_WON) {
+        replayFinish();
+        linkSend(LINK_STATE, 2, 0);
+        animSweep();
+        soundPlay(soundWin);
+        state = Game_Won;
+      }
       break;
 
     case Game_Won:
-      break;
-
     case Game_Lose:
-      fillRect(0, 0, 127, 127, RED);
+      // until a transaction starts a new game
+      break;
   }
+  return state;
 }
 
+// task list, adding a task is one more line here
+typedef Scheduler<
+  Task<LCD_Tick, LCD_PERIOD, LCD_Init>,
+  Task<Joystick_Tick, JOYSTICK_PERIOD, Joystick_Run>,
+  Task<Game_Tick, GAME_PERIOD, Game_Run>
+> Tasks;
+
+// number of tasks, for the per-task arrays
+static const uint8_t NUM_TASKS = Tasks::count;
+
+// task statistics, see TASK_STATS above
+#ifdef TASK_STATS
+uint16_t taskTicks[NUM_TASKS];
+uint16_t taskOverruns[NUM_TASKS];
+int8_t slowTask = -1; // task that ran longest in the current tick, -1 = none yet
+uint16_t slowTime = 0; // and how long, in Timer1 counts
+uint16_t statsNext = 1000; // sysTime of the next report
+
+// a second's figures, taken by TimerISR() and printed by the main loop, the report is
+// about 150 bytes and takes about 150 ms at 9600 baud, which the scheduler can't wait for
+struct taskReport {
+  uint16_t ticks[NUM_TASKS];
+  uint16_t overruns[NUM_TASKS];
+  uint8_t revealed;
+  bool lost;
+  bool won;
+  uint8_t bv;
+  uint8_t solved;
+  uint16_t clicks;
+};
+taskReport report;
+volatile bool reportReady = false; // set by TimerISR(), cleared once the main loop printed it
+#endif
+
+const unsigned long GCD_PERIOD = Tasks::gcd;
+// Timer1 runs free at 2 MHz, see gpioInit(), and times the ticks
+const uint16_t TIMER1_PER_MS = 2000;
+static_assert(GCD_PERIOD * TIMER1_PER_MS < 65536UL, "a GCD period must fit in a Timer1 wrap");
+static_assert(REPLAY_EVENT_BYTES * GCD_PERIOD <= JOYSTICK_PERIOD, "the replay queue must drain faster than a recording fills it");
+
 // executes tasks
 void TimerISR() {   
-  // Iterate through each task in the task array
-	for (unsigned int i = 0; i < NUM_TASKS; i++ ) {
-    // Check if the task is ready to tick    
-		if ( tasks[i].elapsedTime == tasks[i].period ) {
-      // Tick and set the next state for this task      
-			tasks[i].state = tasks[i].TickFct(tasks[i].state); 
-      // Reset the elapsed time for the next tick
-			tasks[i].elapsedTime = 0;                          
-		}
-    // Increment the elapsed time by GCD_PERIOD
-		tasks[i].elapsedTime += GCD_PERIOD;
-	}
+  uint16_t began = TCNT1;
+  sysTime += GCD_PERIOD;
+#ifdef TASK_STATS
+  slowTask = -1;
+  slowTime = 0;
+#endif
+
+  // let the UART interrupts in while tasks run, so received bytes aren't lost during long frames
+  // the timer interrupt gets in too, but leaves the ticks to this one until it returns
+  sei();
+
+  Tasks::run();
+
+#if INPUT_MODE == INPUT_RECORD
+  // an EEPROM byte per tick keeps up with an event every joystick tick
+  replayFlush();
+#endif
+
+#ifdef COMMAND_MODE
+  // a CMD_DUMP reply goes out a TX buffer per tick, the line empties it in about 2.6 ms
+  dumpStep();
+#endif
+
+#ifdef TASK_STATS
+  if ((int16_t)(sysTime - statsNext) >= 0) {
+    statsNext += 1000;
+    // while the last report is still being printed the counts carry on into the next one
+    if (!reportReady) {
+      for (uint8_t i = 0; i < NUM_TASKS; i++) {
+        report.ticks[i] = taskTicks[i];
+        report.overruns[i] = taskOverruns[i];
+        taskTicks[i] = 0;
+        taskOverruns[i] = 0;
+      }
+      report.revealed = cellsRevealed;
+      report.lost = gameLost;
+      report.won = gameWon;
+      report.bv = board3BV;
+      report.solved = solved3BV;
+      report.clicks = boardClicks;
+      asm volatile("" ::: "memory"); // the report is written before it is handed over
+      reportReady = true;
+    }
+  }
+#endif
+
+  cli();
+
+  // the next tick comes GCD_PERIOD after this one returns, so a tick that ran long moves the
+  // schedule back by the whole ms it took: sysTime catches up by those, and the GCD periods
+  // it ran past are ticks the scheduler missed, Timer1 wraps every 32 ms, a tick that ran
+  // longer than that is undercounted by the wraps
+  uint16_t took = TCNT1 - began;
+  sysTime += took / TIMER1_PER_MS;
+#ifdef TASK_STATS
+  if (slowTask >= 0) { taskOverruns[slowTask] += took / (uint16_t)(GCD_PERIOD * TIMER1_PER_MS); }
+#endif
+}
+
+#ifdef TASK_STATS
+// prints the report TimerISR() handed over, with interrupts on, so the tasks keep running
+void taskReportPrint() {
+  serial_println("Task ticks/overruns:");
+  for (uint8_t i = 0; i < NUM_TASKS; i++) {
+    serial_println(report.ticks[i]);
+    serial_println(report.overruns[i]);
+  }
+  serial_println("Game revealed/lost/won:");
+  serial_println(report.revealed);
+  serial_println(report.lost);
+  serial_println(report.won);
+  serial_println("3BV/solved/clicks:");
+  serial_println(report.bv);
+  serial_println(report.solved);
+  serial_println(report.clicks);
+  serial_println("RAM static/stack headroom:");
+  serial_println(ramStatic());
+  serial_println(stackHeadroom());
 }
+#endif
 
 int main() {
   // gpio initialization
@@ -208,31 +461,37 @@ int main() {
   // ADC initialization
   ADC_init();
 
-  // serial initialization
-  serial_init(9600);
-
-  // concurrent fsm task initialization
-  tasks[0].state = LCD_Init; // Task initial state
-  tasks[0].period = LCD_PERIOD; // Task period
-  tasks[0].elapsedTime = tasks[0].period; // Task elapsed time
-  tasks[0].TickFct = &LCD_Tick; // Task tick function
+  // buzzer initialization
+  soundInit();
 
-  tasks[1].state = Joystick_Run; // Task initial state
-  tasks[1].period = JOYSTICK_PERIOD; // Task period
-  tasks[1].elapsedTime = tasks[1].period; // Task elapsed time
-  tasks[1].TickFct = &Joystick_Tick; // Task tick function
+  // board and sprite geometry, before LCD_Tick generates the first board
+  setZoom(zoom);
 
-  tasks[2].state = Game_Run; // Task initial state
-  tasks[2].period = GAME_PERIOD; // Task period
-  tasks[2].elapsedTime = tasks[2].period; // Task elapsed time
-  tasks[2].TickFct = &Game_Tick; // Task tick function
+  // serial initialization
+#if defined(VERSUS_MODE)
+  uart_init(LINK_BAUD);
+#elif defined(LCD_CAPTURE)
+  uart_init(LCD_CAPTURE_BAUD);
+#elif defined(COMMAND_MODE)
+  uart_init(COMMAND_BAUD);
+#else
+  serial_init(9600);
+#endif
 
   // timer initialization
   TimerSet(GCD_PERIOD);
   TimerOn();
 
-  // main loop (should never reach here)
-  while (1) { }
+  // the tasks run from the timer interrupt, the main loop only sends what is too slow for it
+  while (1) {
+#ifdef TASK_STATS
+    if (reportReady) {
+      asm volatile("" ::: "memory"); // and read after it was
+      taskReportPrint();
+      reportReady = false;
+    }
+#endif
+  }
   
   return 0;
 }
@@ -0,0 +1,13 @@
+// host stand-in for <avr/eeprom.h>, backed by the harness's eeprom[] array
+#pragma once
+#include <stdint.h>
+
+// EEMEM variables go in a section of their own, as they do in .eeprom on the device, so their
+// EEPROM addresses are offsets from its start and the same in every build and run
+#define EEMEM __attribute__((section("host_eeprom")))
+
+uint8_t eeprom_read_byte(const uint8_t *p);
+void eeprom_update_byte(uint8_t *p, uint8_t v);
+uint16_t eeprom_read_word(const uint16_t *p);
+void eeprom_update_word(uint16_t *p, uint16_t v);
+int eeprom_is_ready(void);
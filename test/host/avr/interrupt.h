@@ -0,0 +1,8 @@
+// host stand-in for <avr/interrupt.h>: the harness calls the vectors itself, sei() and cli()
+// set the I bit in SREG, which the harness checks before it fires a vector in the middle of a tick
+#pragma once
+#include "io.h"
+
+#define ISR(v) extern "C" void v(void)
+#define sei() (SREG.v |= 0x80)
+#define cli() (SREG.v &= ~0x80)
@@ -0,0 +1,102 @@
+// host stand-in for <avr/io.h>: the registers the firmware touches, plain bytes except the
+// ones whose accesses do something, those are small structs whose operators harness.cpp defines
+#pragma once
+#include <stdint.h>
+
+// writing SPDR puts the byte on the LCD model's bus
+struct SpdrReg {
+    void operator=(uint8_t b);
+};
+
+// setting ADSC converts at once, from the harness's adc[] inputs
+struct AdcReg {
+    uint8_t v;
+    AdcReg &operator|=(int x);
+    operator uint8_t() const { return v; }
+};
+
+// writing UDR0 sends a byte, reading it takes the next received one
+struct UdrReg {
+    void operator=(uint8_t b);
+    operator uint8_t() const;
+};
+
+// setting the I bit (sei in TimerOn) ends boot(), the firmware's main loop never runs on the host
+struct SregReg {
+    uint8_t v;
+    SregReg &operator|=(int x);
+    SregReg &operator=(uint8_t x) { v = x; return *this; }
+    operator uint8_t() const { return v; }
+};
+
+// SPIF always reads set, every SPI transfer is done at once
+struct SpsrReg {
+    uint8_t v;
+    void operator=(uint8_t x) { v = x; }
+    operator uint8_t() const { return v | 0x80; }
+};
+
+// enabling UDRIE0 drains the TX ring on the spot
+struct UcsrReg {
+    uint8_t v;
+    void operator|=(int x);
+    void operator&=(int x) { v &= x; }
+    void operator=(int x) { v = x; }
+    operator uint8_t() const { return v; }
+};
+
+extern SpdrReg SPDR;
+extern AdcReg ADCSRA;
+extern UdrReg UDR0;
+extern SregReg SREG;
+extern SpsrReg SPSR_reg;
+#define SPSR SPSR_reg
+extern UcsrReg UCSR0B;
+
+#define HOST_REG(n) extern volatile uint8_t n;
+HOST_REG(PORTB) HOST_REG(PORTC) HOST_REG(PORTD) HOST_REG(DDRB) HOST_REG(DDRC) HOST_REG(DDRD)
+HOST_REG(PINB) HOST_REG(PINC) HOST_REG(PIND)
+HOST_REG(SPCR) HOST_REG(ADMUX) HOST_REG(ADCL) HOST_REG(ADCH)
+HOST_REG(TCCR0A) HOST_REG(TCCR0B) HOST_REG(OCR0A) HOST_REG(TIMSK0) HOST_REG(TCNT0)
+HOST_REG(TCCR1A) HOST_REG(TCCR1B) HOST_REG(TIMSK1) HOST_REG(TIFR1)
+HOST_REG(TCCR2A) HOST_REG(TCCR2B) HOST_REG(OCR2A) HOST_REG(TIMSK2) HOST_REG(TCNT2)
+HOST_REG(UCSR0A) HOST_REG(UCSR0C) HOST_REG(MCUSR)
+#undef HOST_REG
+extern volatile uint16_t TCNT1, ICR1, UBRR0, OCR1A, SP;
+
+enum { PB0, PB1, PB2, PB3, PB4, PB5, PB6, PB7 };
+enum { PC0, PC1, PC2, PC3, PC4, PC5 };
+enum { PD0, PD1, PD2, PD3, PD4, PD5, PD6, PD7 };
+
+#define PORTB5 5
+#define PORTB3 3
+#define PORTB2 2
+#define SPE 6
+#define MSTR 4
+#define SPIF 7
+#define SPI2X 0
+#define REFS0 6
+#define ADEN 7
+#define ADSC 6
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+#define TOIE1 0
+#define ICF1 5
+#define TOV1 0
+#define TXEN0 3
+#define RXEN0 4
+#define RXCIE0 7
+#define UDRIE0 5
+#define UDRE0 5
+#define RXC0 7
+#define UCSZ00 1
+#define WGM01 1
+#define COM0A0 6
+#define CS00 0
+#define CS01 1
+#define CS02 2
+#define OCIE0A 1
+#define CS11 1
+#define RAMEND 0x8FF
+#define E2END 0x3FF
@@ -0,0 +1,10 @@
+// host stand-in for <avr/pgmspace.h>: flash is ordinary memory
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_ptr(p) (*(void *const *)(p))
@@ -0,0 +1,321 @@
+// large-board engine for the host: the firmware's board rules (countMines(), floodReveal()) on
+// boards far past the panel's 16 x 16, e.g. 10000 x 10000, for analysis jobs and stress tests
+// rows are bit-packed 64 cells to a word like mineCells[], mine counts are generated for whole
+// words at once into 4 bit planes, with AVX2 or SSE2 when the CPU has them, and a reveal
+// floods along row spans instead of cell by cell
+#pragma once
+#include <stdint.h>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BIG_X86
+#endif
+
+// which code generates the counts, BIG_BEST picks the widest the CPU has
+enum bigPath { BIG_BEST, BIG_SCALAR, BIG_SSE2, BIG_AVX2 };
+
+// a row sits between a zero word on each side, so the shifted neighbour words of its first and
+// last word can be loaded like any other, and is padded to a multiple of 4 words for AVX2
+struct bigBoard {
+    uint32_t rows = 0;
+    uint32_t cols = 0;
+    uint32_t words = 0; // words that hold cells, per row
+    uint32_t stride = 0; // words per row, padding included
+    std::vector<uint64_t> mines;
+    std::vector<uint64_t> count[4]; // bit planes of the neighbour mine count, 0..8
+    std::vector<uint64_t> empty; // no mine on or around the cell, floods spread from these
+    std::vector<uint64_t> revealed;
+    std::vector<uint64_t> blocked; // flagged, reveals never go there
+    std::vector<uint64_t> zeros; // the row above the first and below the last
+
+    uint64_t *row(std::vector<uint64_t> &v, uint32_t i) { return &v[(size_t)i * stride + 1]; }
+    bool bit(std::vector<uint64_t> &v, uint32_t i, uint32_t j) { return (row(v, i)[j >> 6] >> (j & 63)) & 1; }
+    void set(std::vector<uint64_t> &v, uint32_t i, uint32_t j) { row(v, i)[j >> 6] |= 1ULL << (j & 63); }
+};
+
+// an empty board
+void bigInit(bigBoard &b, uint32_t rows, uint32_t cols) {
+    b.rows = rows;
+    b.cols = cols;
+    b.words = (cols + 63) / 64;
+    b.stride = (b.words + 3) / 4 * 4 + 2;
+    size_t size = (size_t)rows * b.stride;
+    b.mines.assign(size, 0);
+    for (int p = 0; p < 4; ++p) { b.count[p].assign(size, 0); }
+    b.empty.assign(size, 0);
+    b.revealed.assign(size, 0);
+    b.blocked.assign(size, 0);
+    b.zeros.assign(b.stride, 0);
+}
+
+// random mine placement as placeMines() does it, a position at a time and skipping the ones that
+// already have a mine, from a 64-bit xorshift since a 16-bit LFSR can't reach every cell
+void bigPlaceMines(bigBoard &b, uint64_t seed, uint64_t mines) {
+    uint64_t x = seed | 1;
+    for (uint64_t placed = 0; placed < mines;) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        uint32_t i = (x >> 16) % b.rows;
+        uint32_t j = ((x >> 16) / b.rows) % b.cols;
+        if (!b.bit(b.mines, i, j)) {
+            b.set(b.mines, i, j);
+            placed++;
+        }
+    }
+}
+
+// the count of (i, j), 0..8
+uint8_t bigCount(bigBoard &b, uint32_t i, uint32_t j) {
+    return b.bit(b.count[0], i, j) | (b.bit(b.count[1], i, j) << 1) | (b.bit(b.count[2], i, j) << 2) |
+           (b.bit(b.count[3], i, j) << 3);
+}
+
+// the rows a row's counts come from, and where they go
+struct bigRowJob {
+    const uint64_t *up, *mid, *down;
+    uint64_t *c0, *c1, *c2, *c3, *empty;
+    uint32_t words; // a multiple of 4
+};
+
+// countAdd() for one word of 64 cells
+static inline void bigAdd(uint64_t m, uint64_t &c0, uint64_t &c1, uint64_t &c2, uint64_t &c3) {
+    uint64_t carry = c0 & m;
+    c0 ^= m;
+    m = carry;
+    carry = c1 & m;
+    c1 ^= m;
+    m = carry;
+    carry = c2 & m;
+    c2 ^= m;
+    c3 |= carry;
+}
+
+static void bigCountRowScalar(const bigRowJob &r) {
+    for (uint32_t k = 0; k < r.words; ++k) {
+        uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+        const uint64_t *src[3] = {r.up, r.mid, r.down};
+        for (int s = 0; s < 3; ++s) {
+            const uint64_t *p = src[s] + k;
+            // bit j of west is cell j - 1, of east cell j + 1
+            uint64_t west = (p[0] << 1) | (p[-1] >> 63);
+            uint64_t east = (p[0] >> 1) | (p[1] << 63);
+            bigAdd(west, c0, c1, c2, c3);
+            bigAdd(east, c0, c1, c2, c3);
+            if (s != 1) { bigAdd(p[0], c0, c1, c2, c3); }
+        }
+        r.c0[k] = c0;
+        r.c1[k] = c1;
+        r.c2[k] = c2;
+        r.c3[k] = c3;
+        r.empty[k] = ~(r.mid[k] | c0 | c1 | c2 | c3);
+    }
+}
+
+#ifdef BIG_X86
+#define BIG_ADD(m, and_, xor_, or_) do { \
+        auto carry = and_(c0, m); c0 = xor_(c0, m); m = carry; \
+        carry = and_(c1, m); c1 = xor_(c1, m); m = carry; \
+        carry = and_(c2, m); c2 = xor_(c2, m); c3 = or_(c3, carry); } while (0)
+
+__attribute__((target("sse2"))) static void bigCountRowSse2(const bigRowJob &r) {
+    for (uint32_t k = 0; k < r.words; k += 2) {
+        __m128i c0 = _mm_setzero_si128(), c1 = c0, c2 = c0, c3 = c0;
+        const uint64_t *src[3] = {r.up, r.mid, r.down};
+        for (int s = 0; s < 3; ++s) {
+            const uint64_t *p = src[s] + k;
+            __m128i x = _mm_loadu_si128((const __m128i *)p);
+            __m128i west = _mm_or_si128(_mm_slli_epi64(x, 1), _mm_srli_epi64(_mm_loadu_si128((const __m128i *)(p - 1)), 63));
+            __m128i east = _mm_or_si128(_mm_srli_epi64(x, 1), _mm_slli_epi64(_mm_loadu_si128((const __m128i *)(p + 1)), 63));
+            BIG_ADD(west, _mm_and_si128, _mm_xor_si128, _mm_or_si128);
+            BIG_ADD(east, _mm_and_si128, _mm_xor_si128, _mm_or_si128);
+            if (s != 1) { BIG_ADD(x, _mm_and_si128, _mm_xor_si128, _mm_or_si128); }
+        }
+        _mm_storeu_si128((__m128i *)(r.c0 + k), c0);
+        _mm_storeu_si128((__m128i *)(r.c1 + k), c1);
+        _mm_storeu_si128((__m128i *)(r.c2 + k), c2);
+        _mm_storeu_si128((__m128i *)(r.c3 + k), c3);
+        __m128i any = _mm_or_si128(_mm_or_si128(c0, c1), _mm_or_si128(c2, c3));
+        any = _mm_or_si128(any, _mm_loadu_si128((const __m128i *)(r.mid + k)));
+        _mm_storeu_si128((__m128i *)(r.empty + k), _mm_xor_si128(any, _mm_set1_epi64x(-1)));
+    }
+}
+
+__attribute__((target("avx2"))) static void bigCountRowAvx2(const bigRowJob &r) {
+    for (uint32_t k = 0; k < r.words; k += 4) {
+        __m256i c0 = _mm256_setzero_si256(), c1 = c0, c2 = c0, c3 = c0;
+        const uint64_t *src[3] = {r.up, r.mid, r.down};
+        for (int s = 0; s < 3; ++s) {
+            const uint64_t *p = src[s] + k;
+            __m256i x = _mm256_loadu_si256((const __m256i *)p);
+            __m256i west = _mm256_or_si256(_mm256_slli_epi64(x, 1), _mm256_srli_epi64(_mm256_loadu_si256((const __m256i *)(p - 1)), 63));
+            __m256i east = _mm256_or_si256(_mm256_srli_epi64(x, 1), _mm256_slli_epi64(_mm256_loadu_si256((const __m256i *)(p + 1)), 63));
+            BIG_ADD(west, _mm256_and_si256, _mm256_xor_si256, _mm256_or_si256);
+            BIG_ADD(east, _mm256_and_si256, _mm256_xor_si256, _mm256_or_si256);
+            if (s != 1) { BIG_ADD(x, _mm256_and_si256, _mm256_xor_si256, _mm256_or_si256); }
+        }
+        _mm256_storeu_si256((__m256i *)(r.c0 + k), c0);
+        _mm256_storeu_si256((__m256i *)(r.c1 + k), c1);
+        _mm256_storeu_si256((__m256i *)(r.c2 + k), c2);
+        _mm256_storeu_si256((__m256i *)(r.c3 + k), c3);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(c0, c1), _mm256_or_si256(c2, c3));
+        any = _mm256_or_si256(any, _mm256_loadu_si256((const __m256i *)(r.mid + k)));
+        _mm256_storeu_si256((__m256i *)(r.empty + k), _mm256_xor_si256(any, _mm256_set1_epi64x(-1)));
+    }
+}
+#undef BIG_ADD
+#endif
+
+// the path BIG_BEST stands for on this CPU
+bigPath bigBestPath() {
+#ifdef BIG_X86
+    if (__builtin_cpu_supports("avx2")) { return BIG_AVX2; }
+    if (__builtin_cpu_supports("sse2")) { return BIG_SSE2; }
+#endif
+    return BIG_SCALAR;
+}
+
+// generates the counts and the empty cells from the mines, countMines() for the whole board,
+// returns the path it took
+bigPath bigCountMines(bigBoard &b, bigPath path = BIG_BEST) {
+    if (path == BIG_BEST) { path = bigBestPath(); }
+    void (*countRow)(const bigRowJob &) = bigCountRowScalar;
+#ifdef BIG_X86
+    if (path == BIG_SSE2) { countRow = bigCountRowSse2; }
+    if (path == BIG_AVX2) { countRow = bigCountRowAvx2; }
+#else
+    path = BIG_SCALAR;
+#endif
+
+    // the cells past the last column, a whole word of them when the padding holds one
+    uint32_t padded = b.stride - 2;
+    uint64_t lastMask = (b.cols & 63) ? ~0ULL >> (64 - (b.cols & 63)) : ~0ULL;
+    for (uint32_t i = 0; i < b.rows; ++i) {
+        bigRowJob r;
+        r.up = (i > 0) ? b.row(b.mines, i - 1) : &b.zeros[1];
+        r.mid = b.row(b.mines, i);
+        r.down = (i + 1 < b.rows) ? b.row(b.mines, i + 1) : &b.zeros[1];
+        r.c0 = b.row(b.count[0], i);
+        r.c1 = b.row(b.count[1], i);
+        r.c2 = b.row(b.count[2], i);
+        r.c3 = b.row(b.count[3], i);
+        r.empty = b.row(b.empty, i);
+        r.words = padded;
+        countRow(r);
+
+        for (uint32_t k = b.words - 1; k < padded; ++k) {
+            uint64_t keep = (k == b.words - 1) ? lastMask : 0;
+            r.c0[k] &= keep;
+            r.c1[k] &= keep;
+            r.c2[k] &= keep;
+            r.c3[k] &= keep;
+            r.empty[k] &= keep;
+        }
+    }
+    return path;
+}
+
+// a run of empty cells a reveal uncovered, from column a to b
+struct bigSpan {
+    uint32_t i, a, b;
+};
+
+// the empty cells of a word a reveal can still spread to
+static inline uint64_t bigSpread(bigBoard &b, uint32_t i, uint32_t w) {
+    return b.row(b.empty, i)[w] & ~b.row(b.blocked, i)[w] & ~b.row(b.revealed, i)[w];
+}
+
+// the last column of the spreadable run through (i, j), going right
+static uint32_t bigRunEnd(bigBoard &b, uint32_t i, uint32_t j) {
+    uint32_t w = j >> 6;
+    uint64_t gap = ~bigSpread(b, i, w) >> (j & 63);
+    if (gap) { return j + __builtin_ctzll(gap) - 1; }
+    for (++w; w < b.words; ++w) {
+        gap = ~bigSpread(b, i, w);
+        if (gap) { return w * 64 + __builtin_ctzll(gap) - 1; }
+    }
+    return b.cols - 1;
+}
+
+// the first column of the spreadable run through (i, j), going left
+static uint32_t bigRunStart(bigBoard &b, uint32_t i, uint32_t j) {
+    uint32_t w = j >> 6;
+    uint64_t gap = ~bigSpread(b, i, w) << (63 - (j & 63));
+    if (gap) { return j - __builtin_clzll(gap) + 1; }
+    while (w-- > 0) {
+        gap = ~bigSpread(b, i, w);
+        if (gap) { return w * 64 + 63 - __builtin_clzll(gap) + 1; }
+    }
+    return 0;
+}
+
+// the mask of columns a..b within word w
+static inline uint64_t bigRangeMask(uint32_t w, uint32_t a, uint32_t b) {
+    uint64_t m = ~0ULL;
+    if (w == a >> 6) { m &= ~0ULL << (a & 63); }
+    if (w == b >> 6) { m &= ~0ULL >> (63 - (b & 63)); }
+    return m;
+}
+
+// the first spreadable column of row i in a..b, false if there is none
+static bool bigFindSpread(bigBoard &b, uint32_t i, uint32_t a, uint32_t e, uint32_t *j) {
+    for (uint32_t w = a >> 6; w <= e >> 6; ++w) {
+        uint64_t m = bigSpread(b, i, w) & bigRangeMask(w, a, e);
+        if (m) {
+            *j = w * 64 + __builtin_ctzll(m);
+            return true;
+        }
+    }
+    return false;
+}
+
+// reveals columns a..b of row i but the blocked ones, returns how many weren't revealed yet
+static uint64_t bigRevealRange(bigBoard &b, uint32_t i, uint32_t a, uint32_t e) {
+    uint64_t added = 0;
+    uint64_t *rev = b.row(b.revealed, i);
+    const uint64_t *blk = b.row(b.blocked, i);
+    for (uint32_t w = a >> 6; w <= e >> 6; ++w) {
+        uint64_t m = bigRangeMask(w, a, e) & ~blk[w] & ~rev[w];
+        rev[w] |= m;
+        added += __builtin_popcountll(m);
+    }
+    return added;
+}
+
+// reveals (i, j) like floodReveal() with it as the only seed: a mine or a numbered cell on its
+// own, an empty cell with everything it floods to, only through empty cells this reveal
+// uncovers and never into blocked ones, a span at a time: a run of empty cells uncovers the
+// row above and below it one column wider, and the runs found there go on the stack
+// returns the cells newly revealed, 0 if (i, j) was revealed or blocked already
+uint64_t bigReveal(bigBoard &b, uint32_t i, uint32_t j) {
+    if (b.bit(b.revealed, i, j) || b.bit(b.blocked, i, j)) { return 0; }
+    if (!b.bit(b.empty, i, j)) {
+        b.set(b.revealed, i, j);
+        return 1;
+    }
+
+    std::vector<bigSpan> stack;
+    uint32_t a = bigRunStart(b, i, j), e = bigRunEnd(b, i, j);
+    uint64_t added = bigRevealRange(b, i, a, e);
+    stack.push_back({i, a, e});
+    while (!stack.empty()) {
+        bigSpan s = stack.back();
+        stack.pop_back();
+        uint32_t lo = (s.a > 0) ? s.a - 1 : 0;
+        uint32_t hi = (s.b + 1 < b.cols) ? s.b + 1 : s.b;
+        for (int d = -1; d <= 1; d += 2) {
+            if ((d < 0 && s.i == 0) || (d > 0 && s.i + 1 >= b.rows)) { continue; }
+            uint32_t ni = s.i + d;
+            // the runs first, they have to be found before the range is uncovered
+            for (uint32_t from = lo, at; from <= hi && bigFindSpread(b, ni, from, hi, &at); from = e + 1) {
+                a = bigRunStart(b, ni, at);
+                e = bigRunEnd(b, ni, at);
+                added += bigRevealRange(b, ni, a, e);
+                stack.push_back({ni, a, e});
+            }
+            added += bigRevealRange(b, ni, lo, hi);
+        }
+        added += bigRevealRange(b, s.i, lo, hi);
+    }
+    return added;
+}
@@ -0,0 +1,316 @@
+// host harness: builds src/main.cpp for the host against the stand-in AVR headers next to this
+// file, emulates the registers the firmware uses and decodes the LCD's SPI stream into a frame
+// buffer, then a scenario (scenarios/*.h, picked with -DSCENARIO) drives the timer ISR, the
+// joystick and the UART
+// each scenario prints what it checks, run.sh compares that with expected/<name>.txt
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "avr/io.h"
+
+// plain registers
+#define HOST_REG(n) volatile uint8_t n;
+HOST_REG(PORTB) HOST_REG(PORTC) HOST_REG(PORTD) HOST_REG(DDRB) HOST_REG(DDRC) HOST_REG(DDRD)
+HOST_REG(PINB) HOST_REG(PINC) HOST_REG(PIND)
+HOST_REG(SPCR) HOST_REG(ADMUX) HOST_REG(ADCL) HOST_REG(ADCH)
+HOST_REG(TCCR0A) HOST_REG(TCCR0B) HOST_REG(OCR0A) HOST_REG(TIMSK0) HOST_REG(TCNT0)
+HOST_REG(TCCR1A) HOST_REG(TCCR1B) HOST_REG(TIMSK1) HOST_REG(TIFR1)
+HOST_REG(TCCR2A) HOST_REG(TCCR2B) HOST_REG(OCR2A) HOST_REG(TIMSK2) HOST_REG(TCNT2)
+HOST_REG(UCSR0C) HOST_REG(MCUSR)
+#undef HOST_REG
+volatile uint8_t UCSR0A = 0xFF; // the UART is always ready
+volatile uint16_t TCNT1, ICR1, UBRR0, OCR1A, SP;
+SpsrReg SPSR_reg;
+
+// the linker symbols memstats.h reads, __data_start is renamed on the command line
+uint8_t _end, __stack, hostDataStart;
+
+// joystick: analog inputs per ADC channel, set by setInput()
+uint16_t adc[8] = {512, 512};
+AdcReg ADCSRA;
+AdcReg &AdcReg::operator|=(int x) {
+    v |= x;
+    if (v & (1 << ADSC)) {
+        uint16_t r = adc[ADMUX & 7];
+        ADCL = r & 0xFF;
+        ADCH = r >> 8;
+        v &= ~(1 << ADSC);
+    }
+    return *this;
+}
+
+// boot() runs the firmware's main() until it enables interrupts
+static jmp_buf bootDone;
+static bool booting = false;
+SregReg SREG;
+SregReg &SregReg::operator|=(int x) {
+    v |= x;
+    if (booting) {
+        booting = false;
+        longjmp(bootDone, 1);
+    }
+    return *this;
+}
+
+// uart: everything sent collects in serialOut, sendRx() feeds the RX interrupt
+// the ring buffers and their ISRs only exist in the modes uart.h is built for
+#if defined(VERSUS_MODE) || defined(COMMAND_MODE) || defined(LCD_CAPTURE)
+#define HOST_UART
+#endif
+std::string serialOut;
+std::vector<uint8_t> rxQueue;
+#ifdef HOST_UART
+extern "C" void USART_UDRE_vect(void);
+extern "C" void USART_RX_vect(void);
+extern volatile uint8_t uartTxHead, uartTxTail;
+void drainTx() {
+    while (uartTxHead != uartTxTail) { USART_UDRE_vect(); }
+}
+void sendRx(std::vector<uint8_t> bytes) {
+    for (uint8_t b : bytes) {
+        rxQueue.push_back(b);
+        USART_RX_vect();
+    }
+}
+#endif
+UdrReg UDR0;
+void UdrReg::operator=(uint8_t b) { serialOut.push_back((char)b); }
+UdrReg::operator uint8_t() const {
+    if (rxQueue.empty()) { return 0; }
+    uint8_t b = rxQueue.front();
+    rxQueue.erase(rxQueue.begin());
+    return b;
+}
+// the line is infinitely fast: enabling UDRIE sends the whole ring at once
+// with -DUART_TIME it sends at the baud rate instead, as runMs() moves the clock
+UcsrReg UCSR0B;
+void UcsrReg::operator|=(int x) {
+    v |= x;
+#if defined(HOST_UART) && !defined(UART_TIME)
+    static bool draining = false;
+    if ((v & (1 << UDRIE0)) && !draining) {
+        draining = true;
+        while (v & (1 << UDRIE0)) { USART_UDRE_vect(); }
+        draining = false;
+    }
+#endif
+}
+
+// eeprom, eeReady = 0 makes every write wait
+uint8_t eeprom[E2END + 1];
+int eeReady = 1;
+int eeprom_is_ready() { return eeReady; }
+extern "C" uint8_t __start_host_eeprom[]; // the linker's, see avr/eeprom.h
+uint8_t eeprom_read_byte(const uint8_t *p) { return eeprom[(p - __start_host_eeprom) & E2END]; }
+void eeprom_update_byte(uint8_t *p, uint8_t v) { eeprom[(p - __start_host_eeprom) & E2END] = v; }
+uint16_t eeprom_read_word(const uint16_t *p) {
+    return eeprom_read_byte((const uint8_t *)p) | (eeprom_read_byte((const uint8_t *)p + 1) << 8);
+}
+void eeprom_update_word(uint16_t *p, uint16_t v) {
+    eeprom_update_byte((uint8_t *)p, v);
+    eeprom_update_byte((uint8_t *)p + 1, v >> 8);
+}
+
+void _delay_ms(double) {}
+void _delay_us(double) {}
+
+// the clock, with -DBUS_TIME: SPI bytes and runMs() move it, TCNT1 shows it in 0.5 us counts,
+// and the 1 ms timer vector fires on it, in the middle of a tick too once TimerISR() enabled
+// interrupts, as it does on the device, without it TCNT1 stands still
+static void clockVector();
+#ifdef BUS_TIME
+static long clockNow = 0, clockUntil = 0, clockNextMs = 2000;
+static void clockMove(long counts) {
+    clockNow += counts;
+    TCNT1 = clockNow;
+    while (clockNow >= clockNextMs && (SREG & 0x80)) {
+        clockNextMs += 2000;
+        clockVector();
+    }
+}
+#endif
+
+// lcd model: CASET/RASET windows, COLMOD and RAMWR pixels in 5-6-5 or 4-4-4, in panel memory
+// order (the ILI9341 build sets MV, so its memory is the 320-wide screen as is)
+// busBytes counts every SPI byte, with -DBUS_TIME each byte also moves the clock by 2.5 us
+uint16_t fb[320][320];
+long busBytes = 0;
+static int lcdCmd = -1, lcdArgs = 0, colorMode = 5;
+static uint8_t windowArgs[4], pixelBytes[3];
+static int pixelCount = 0, xs, xe, ys, ye, cx, cy;
+
+static void putPixel(uint16_t c) {
+    if (cy < 320 && cx < 320) { fb[cy][cx] = c; }
+    if (++cx > xe) {
+        cx = xs;
+        if (++cy > ye) { cy = ys; }
+    }
+}
+
+static uint16_t expand444(uint16_t p) {
+    return (((p >> 8) & 15) << 12) | (((p >> 4) & 15) << 7) | ((p & 15) << 1);
+}
+
+SpdrReg SPDR;
+void SpdrReg::operator=(uint8_t b) {
+    busBytes++;
+#ifdef LCD_CAPTURE
+    drainTx();
+#endif
+#ifdef BUS_TIME
+    clockMove(5);
+#endif
+    const bool data = PORTB & 1; // A0 on PB0
+#ifdef LOG_PWR
+    if (!data && (b == 0x12 || b == 0x13 || b == 0x30 || b == 0x38 || b == 0x39)) { printf("  [lcd cmd %02x]\n", b); }
+    if (data && lcdCmd == 0x30) { printf("  [ptlar %02x]\n", b); }
+#endif
+    if (!data) {
+        lcdCmd = b;
+        lcdArgs = 0;
+        pixelCount = 0;
+        if (lcdCmd == 0x2C) {
+            cx = xs;
+            cy = ys;
+        }
+        return;
+    }
+    if (lcdCmd == 0x2A || lcdCmd == 0x2B) {
+        if (lcdArgs >= 4) { return; }
+        windowArgs[lcdArgs++] = b;
+        if (lcdArgs == 4) {
+            int start = (windowArgs[0] << 8) | windowArgs[1];
+            int end = (windowArgs[2] << 8) | windowArgs[3];
+            if (lcdCmd == 0x2A) { xs = start; xe = end; }
+            else { ys = start; ye = end; }
+        }
+    } else if (lcdCmd == 0x3A) {
+        colorMode = b & 7;
+    } else if (lcdCmd == 0x2C) {
+        pixelBytes[pixelCount++] = b;
+        if (colorMode == 5 && pixelCount == 2) {
+            putPixel((pixelBytes[0] << 8) | pixelBytes[1]);
+            pixelCount = 0;
+        }
+        if (colorMode == 3 && pixelCount == 3) {
+            putPixel(expand444((pixelBytes[0] << 4) | (pixelBytes[1] >> 4)));
+            putPixel(expand444(((pixelBytes[1] & 15) << 8) | pixelBytes[2]));
+            pixelCount = 0;
+        }
+    }
+}
+
+#define main firmwareMain
+#include "../../src/main.cpp"
+#undef main
+
+extern "C" void TIMER2_COMPA_vect(void);
+
+// the timer vector, entered with the I bit clear and left with it as it was, like reti
+static void clockVector() {
+    uint8_t sreg = SREG;
+    cli();
+    TIMER2_COMPA_vect();
+    SREG = sreg;
+}
+
+// the largest number of bus bytes a single 1 ms tick has sent so far
+long maxTick = 0;
+
+// called after every ms runMs() moves on, a scenario that runs next to another copy of the
+// firmware trades what went over the line there
+void (*afterMs)() = 0;
+
+// runs the 1 ms timer interrupt ms times, with -DBUS_TIME moves the clock ms on instead, a
+// tick that ran past the next ms already had the vector fire inside it
+void runMs(int ms) {
+    for (int i = 0; i < ms; i++) {
+        long before = busBytes;
+#ifdef BUS_TIME
+        for (clockUntil += 2000; clockNextMs <= clockUntil;) {
+            if (clockNow < clockNextMs) { clockNow = clockNextMs; }
+            TCNT1 = clockNow;
+            clockNextMs += 2000;
+            clockVector();
+        }
+#else
+        clockVector();
+#endif
+#ifdef LCD_CAPTURE
+        drainTx();
+#endif
+#if defined(HOST_UART) && defined(UART_TIME)
+        // 10 bits a byte at 16 MHz / (16 * (UBRR0 + 1)) baud
+        static long lineBits = 0;
+        lineBits += 1000000L / (UBRR0 + 1);
+        for (; lineBits >= 10000 && (UCSR0B & (1 << UDRIE0)); lineBits -= 10000) { USART_UDRE_vect(); }
+        if (!(UCSR0B & (1 << UDRIE0))) { lineBits = 0; }
+#endif
+        if (busBytes - before > maxTick) { maxTick = busBytes - before; }
+        if (afterMs) { afterMs(); }
+    }
+}
+
+// x and y zones: 0 low, 1 centre, 2 high
+void setInput(int xZone, int yZone, bool press) {
+    adc[0] = xZone == 0 ? 0 : xZone == 2 ? 1023 : 512;
+    adc[1] = yZone == 0 ? 0 : yZone == 2 ? 1023 : 512;
+    PINC = press ? 0 : (1 << SELECT_BUTTON);
+}
+
+void boot() {
+    booting = true;
+    if (!setjmp(bootDone)) { firmwareMain(); }
+}
+
+// hash of what the panel shows, the golden value of a frame
+uint32_t frameHash() {
+    uint32_t h = 2166136261u;
+    for (int y = Display::y0; y < Display::y0 + Display::height; y++) {
+        for (int x = Display::x0; x < Display::x0 + Display::width; x++) {
+            h = (h ^ (fb[y][x] & 0xFF)) * 16777619u;
+            h = (h ^ (fb[y][x] >> 8)) * 16777619u;
+        }
+    }
+    return h;
+}
+
+// prints a frame's hash, and saves it as $HOST_OUT/<name>.ppm when HOST_OUT is set
+void frame(const char *name) {
+    printf("frame %s %08x\n", name, (unsigned)frameHash());
+    const char *dir = getenv("HOST_OUT");
+    if (!dir || !*dir) { return; }
+    std::string path = std::string(dir) + "/" + name + ".ppm";
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f) { return; }
+    fprintf(f, "P6 %d %d 255\n", (int)Display::width, (int)Display::height);
+    for (int y = Display::y0; y < Display::y0 + Display::height; y++) {
+        for (int x = Display::x0; x < Display::x0 + Display::width; x++) {
+            uint16_t c = fb[y][x];
+            uint8_t rgb[3] = {(uint8_t)((c >> 11) << 3), (uint8_t)(((c >> 5) & 63) << 2), (uint8_t)((c & 31) << 3)};
+            fwrite(rgb, 1, 3, f);
+        }
+    }
+    fclose(f);
+}
+
+static int failures = 0;
+
+// a hard check on top of the expected output, for bounds that must hold whatever the numbers
+void expect(bool ok, const char *what) {
+    if (!ok) {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+#include SCENARIO
+
+int main() {
+    scenario();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+#!/bin/sh
+# builds the firmware for the host once per scenario and compares what each scenario prints,
+# frame hashes included, with expected/<name>.txt
+# usage: test/host/run.sh [--update] [name...]
+#   --update rewrites the expected output instead of comparing, review the diff before committing
+#   HOST_OUT=dir also saves every checked frame as dir/<name>/<frame>.ppm
+#   CXX picks the compiler, g++ by default
+set -u
+HERE=$(cd "$(dirname "$0")" && pwd)
+BUILD=${TMPDIR:-/tmp}/minesweeper-host
+CXX=${CXX:-g++}
+# everything -Wall finds fails the build, but for one thing the vendored serialATmega.h brings:
+# serial_println() takes a char *, and the firmware hands it string literals
+WARNINGS="-Wall -Werror -Wno-write-strings"
+
+UPDATE=0
+if [ "${1:-}" = "--update" ]; then
+    UPDATE=1
+    shift
+fi
+
+# name, scenario file and the build flags
+SCENARIOS="
+basic basic.h
+basic_bus basic.h -DBUS_TIME
+basic_12bit basic.h -DCOLOR_12BIT
+redraw redraw.h -DBUS_TIME
+commands commands.h -DCOMMAND_MODE
+commands_line commands.h -DCOMMAND_MODE -DUART_TIME
+zoom zoom.h -DCOMMAND_MODE -DBUS_TIME
+zoom_ili9341 zoom.h -DCOMMAND_MODE -DBUS_TIME -DLCD_ILI9341
+zoom_line zoom.h -DCOMMAND_MODE -DUART_TIME
+shot shot.h -DCOMMAND_MODE
+chord chord.h -DCOMMAND_MODE
+flood flood.h -DCOMMAND_MODE
+versus versus.h -DVERSUS_MODE
+link link.h -DVERSUS_MODE -DUART_TIME
+record replay.h -DINPUT_MODE=INPUT_RECORD
+replay replay.h -DINPUT_MODE=INPUT_REPLAY
+idle idle.h -DLOG_PWR
+idle_zoom idle_zoom.h -DLOG_PWR -DCOMMAND_MODE -DZOOM_DEFAULT=2
+fleet fleet.h -DBUS_TIME
+overrun overrun.h -DBUS_TIME -DTASK_STATS
+big big.h -O2
+"
+
+mkdir -p "$BUILD"
+failed=0
+while read -r name file flags; do
+    [ -n "$name" ] || continue
+    if [ $# -gt 0 ]; then
+        case " $* " in *" $name "*) ;; *) continue ;; esac
+    fi
+    if ! $CXX -std=gnu++11 -O1 $WARNINGS -I "$HERE" -I "$HERE/../../include" -D__AVR_ATmega328P__ \
+        -D__data_start=hostDataStart -DSCENARIO="\"scenarios/$file\"" $flags \
+        "$HERE/harness.cpp" -o "$BUILD/$name"; then
+        echo "$name: build failed"
+        failed=$((failed + 1))
+        continue
+    fi
+    frames=
+    if [ -n "${HOST_OUT:-}" ]; then
+        frames=$HOST_OUT/$name
+        mkdir -p "$frames"
+    fi
+    HOST_OUT=$frames HOST_TMP=$BUILD "$BUILD/$name" > "$BUILD/$name.txt"
+    status=$?
+    if [ $UPDATE -eq 1 ]; then
+        cp "$BUILD/$name.txt" "$HERE/expected/$name.txt"
+        echo "$name: updated"
+    elif diff -u "$HERE/expected/$name.txt" "$BUILD/$name.txt" && [ $status -eq 0 ]; then
+        echo "$name: ok"
+    else
+        echo "$name: FAILED"
+        failed=$((failed + 1))
+    fi
+done <<END
+$SCENARIOS
+END
+
+if [ $failed -ne 0 ]; then
+    echo "$failed failed"
+    exit 1
+fi
@@ -0,0 +1,31 @@
+// joystick play on the default board: reveal, flag, then set off a mine
+#include "common.h"
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    runMs(2100);
+    frame("boot");
+
+    moveTo(3, 0);
+    press();
+    runMs(1500);
+    int selected = 0;
+    for (int i = 0; i < boardRows; ++i) {
+        for (int j = 0; j < boardCols; ++j) { selected += !!(grid[i][j] & CELL_SELECTED); }
+    }
+    printf("cursor %d,%d selected %d sel(3,0) %d revealed %d\n", gridX, gridY, selected, !!(grid[3][0] & CELL_SELECTED),
+           cellsRevealed);
+
+    moveTo(5, 5);
+    longPress();
+    runMs(200);
+    printf("flag(5,5) %d flags %d dropped %d\n", !!(grid[5][5] & CELL_FLAGGED), flagsPlaced, eventsDropped);
+    frame("flag");
+
+    moveTo(1, 1);
+    press();
+    runMs(4000);
+    printf("lost %d busy %d\n", gameLost, animBusy());
+    frame("lost");
+}
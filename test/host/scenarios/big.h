@@ -0,0 +1,150 @@
+// the large-board engine (bigboard.h): it must give what the firmware gives on the boards the
+// firmware makes, the same counts on every path the CPU has, and get through 10000 x 10000
+// boards in milliseconds, the times go to stderr so the expected output doesn't depend on them
+// environment: BIG_SIZE (default 10000) for the side of the large boards
+#include <chrono>
+#include "../bigboard.h"
+#include "common.h"
+
+static double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// FNV-1a over a bitmap's cells
+static uint32_t bigHash(bigBoard &b, std::vector<uint64_t> &v) {
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < b.rows; ++i) {
+        for (uint32_t w = 0; w < b.words; ++w) {
+            uint64_t x = b.row(v, i)[w];
+            for (int k = 0; k < 8; ++k, x >>= 8) { h = (h ^ (x & 0xFF)) * 16777619u; }
+        }
+    }
+    return h;
+}
+
+static uint64_t bigCells(bigBoard &b, std::vector<uint64_t> &v) {
+    uint64_t n = 0;
+    for (uint32_t i = 0; i < b.rows; ++i) {
+        for (uint32_t w = 0; w < b.words; ++w) { n += __builtin_popcountll(b.row(v, i)[w]); }
+    }
+    return n;
+}
+
+// the firmware's current board, counts and empty cells against the engine's, then floodReveal()
+// from every cell against bigReveal(), with some flags down and an opening revealed before
+static int firmwareCheck(uint32_t *rng) {
+    bigBoard b;
+    bigInit(b, boardRows, boardCols);
+    for (int i = 0; i < boardRows; ++i) {
+        for (int j = 0; j < boardCols; ++j) {
+            if ((mineCells[i] >> j) & 1) { b.set(b.mines, i, j); }
+        }
+    }
+    bigCountMines(b);
+    bool same = true;
+    for (int i = 0; i < boardRows; ++i) {
+        if (b.row(b.empty, i)[0] != emptyCells[i]) { same = false; }
+        for (int j = 0; j < boardCols; ++j) {
+            uint8_t status = grid[i][j] & CELL_STATUS;
+            uint8_t n = bigCount(b, i, j);
+            if (status != EXPLODED_MINE && status != (n < NUMBER_3 ? n : NUMBER_3)) { same = false; }
+        }
+    }
+    expect(same, "the engine's counts differ from countMines()");
+
+    uint16_t flags[MAX_ROWS], before[MAX_ROWS], seeds[MAX_ROWS];
+    for (int i = 0; i < boardRows; ++i) {
+        *rng = *rng * 1103515245u + 12345u;
+        flags[i] = (*rng >> 8) & (*rng >> 16) & ~mineCells[i] & lineMask; // about one in four
+        before[i] = 0;
+        seeds[i] = 0;
+    }
+    seeds[(*rng >> 4) % boardRows] = 1U << ((*rng >> 12) % boardCols);
+    floodReveal(before, flags, seeds);
+
+    int reveals = 0;
+    for (int i = 0; i < boardRows; ++i) {
+        for (int j = 0; j < boardCols; ++j) {
+            if (((mineCells[i] | flags[i] | before[i]) >> j) & 1) { continue; }
+            uint16_t fw[MAX_ROWS];
+            for (int k = 0; k < boardRows; ++k) {
+                fw[k] = before[k];
+                seeds[k] = (k == i) ? 1U << j : 0;
+                b.row(b.revealed, k)[0] = before[k];
+                b.row(b.blocked, k)[0] = flags[k];
+            }
+            uint8_t n = floodReveal(fw, flags, seeds);
+            uint64_t m = bigReveal(b, i, j);
+            bool match = (m == n);
+            for (int k = 0; k < boardRows; ++k) {
+                if (b.row(b.revealed, k)[0] != fw[k]) { match = false; }
+            }
+            expect(match, "bigReveal() differs from floodReveal()");
+            reveals++;
+        }
+    }
+    return reveals;
+}
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    runMs(2100);
+
+    // the firmware's rules, on its own boards at every zoom level
+    uint32_t rng = 1;
+    int boards = 0, reveals = 0;
+    for (uint8_t z = 0; z < ZOOM_LEVELS; ++z) {
+        setZoom(z);
+        for (int n = 0; n < 8; ++n) {
+            boardSeed = 0x1234 + 77 * boards;
+            initGrid();
+            boardFinish();
+            reveals += firmwareCheck(&rng);
+            boards++;
+        }
+    }
+    printf("firmware rules: %d boards, %d reveals checked\n", boards, reveals);
+
+    // every path on a board whose width leaves a part word and part vector at the end
+    bigBoard b;
+    bigInit(b, 500, 1000);
+    bigPlaceMines(b, 7, 500 * 1000 / 5);
+    uint32_t ref = 0;
+    for (int p = BIG_SCALAR; p <= BIG_AVX2; ++p) {
+        if (p > bigBestPath()) { continue; }
+        bigCountMines(b, (bigPath)p);
+        uint32_t h = bigHash(b, b.count[0]) ^ bigHash(b, b.count[1]) * 3 ^ bigHash(b, b.count[2]) * 5 ^
+                     bigHash(b, b.count[3]) * 7 ^ bigHash(b, b.empty) * 11;
+        if (p == BIG_SCALAR) { ref = h; }
+        expect(h == ref, "a SIMD path counts differently from the scalar one");
+    }
+    printf("paths: counts %08x, empty cells %llu\n", ref, (unsigned long long)bigCells(b, b.empty));
+
+    // a large board: generation, then a reveal on a sparse one, where one opening spans the board
+    uint32_t side = atoi(getenv("BIG_SIZE") ? getenv("BIG_SIZE") : "10000");
+    bigInit(b, side, side);
+    bigPlaceMines(b, 2024, (uint64_t)side * side * 15 / 100);
+    auto start = std::chrono::steady_clock::now();
+    bigPath path = bigCountMines(b);
+    double countMs = msSince(start);
+    printf("%u x %u, 15%% mines: %llu empty cells, counts %08x\n", side, side,
+           (unsigned long long)bigCells(b, b.empty), bigHash(b, b.count[0]) ^ bigHash(b, b.count[1]) * 3);
+
+    bigInit(b, side, side);
+    bigPlaceMines(b, 2025, (uint64_t)side * side * 5 / 100);
+    bigCountMines(b);
+    uint32_t i = side / 2, j = side / 2;
+    while (!b.bit(b.empty, i, j)) { j++; }
+    start = std::chrono::steady_clock::now();
+    uint64_t revealed = bigReveal(b, i, j);
+    double revealMs = msSince(start);
+    printf("%u x %u, 5%% mines: a click at %u,%u reveals %llu cells\n", side, side, i, j, (unsigned long long)revealed);
+    expect(revealed == bigCells(b, b.revealed), "bigReveal() miscounted");
+
+    static const char *const pathNames[] = {"best", "scalar", "SSE2", "AVX2"};
+    fprintf(stderr, "big: counts in %.1f ms (%s, %.0f Mcells/s), reveal in %.1f ms (%.0f Mcells/s)\n", countMs,
+            pathNames[path], (double)side * side / countMs / 1000, revealMs, revealed / revealMs / 1000);
+    // generous, a cell-by-cell port takes minutes at this size
+    expect(countMs < 2000 && revealMs < 10000, "the large board took seconds");
+}
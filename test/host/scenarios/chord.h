@@ -0,0 +1,101 @@
+// COMMAND_MODE: chording on a revealed number, with the right flags and with a wrong one, then
+// a won game, the renderer must catch up with the board every time
+#include "common.h"
+
+static int stale() {
+    int n = 0;
+    for (int i = 0; i < boardRows; ++i) {
+        for (int j = 0; j < boardCols; ++j) { n += drawn[i][j] != grid[i][j]; }
+    }
+    return n;
+}
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    runMs(2100);
+    printf("stale after boot %d\n", stale());
+
+    // a safe 1 or 2 away from the edges
+    int ci = -1, cj = -1;
+    for (int i = 1; i < boardRows - 1 && ci < 0; ++i) {
+        for (int j = 1; j < boardCols - 1; ++j) {
+            uint8_t s = grid[i][j] & CELL_STATUS;
+            if (s >= 1 && s <= 2) { ci = i; cj = j; break; }
+        }
+    }
+    at(ci, cj, 0x90);
+    dump();
+    runMs(500);
+    printf("number at %d,%d status %d revealed %d\n", ci, cj, grid[ci][cj] & CELL_STATUS, cellsRevealed);
+
+    at(ci, cj, 0x90);
+    std::vector<uint8_t> d = dump();
+    printf("chord without flags: revealed %d lost %d\n", d[4], d[3]);
+
+    for (int i = ci - 1; i <= ci + 1; ++i) {
+        for (int j = cj - 1; j <= cj + 1; ++j) {
+            if ((mineCells[i] >> j) & 1) { at(i, j, 0xA0); }
+        }
+    }
+    int before = cellsRevealed, clicks = boardClicks;
+    at(ci, cj, 0x90);
+    d = dump();
+    int covered = 0;
+    for (int i = ci - 1; i <= ci + 1; ++i) {
+        for (int j = cj - 1; j <= cj + 1; ++j) { covered += !(grid[i][j] & (CELL_REVEALED | CELL_FLAGGED)); }
+    }
+    printf("chord: revealed %d -> %d clicks +%d, covered neighbours left %d lost %d\n", before, cellsRevealed,
+           boardClicks - clicks, covered, d[3]);
+    runMs(3000);
+    printf("stale after chord %d\n", stale());
+    frame("chord");
+
+    // a covered 1 with a safe covered neighbour: reveal it, flag the safe neighbour, chord
+    int mi = -1, mj = -1;
+    for (int i = 1; i < boardRows - 1 && mi < 0; ++i) {
+        for (int j = 1; j < boardCols - 1 && mi < 0; ++j) {
+            if ((grid[i][j] & CELL_STATUS) != 1 || (grid[i][j] & CELL_REVEALED)) { continue; }
+            for (int a = i - 1; a <= i + 1 && mi < 0; ++a) {
+                for (int b = j - 1; b <= j + 1 && mi < 0; ++b) {
+                    if ((a != i || b != j) && !((mineCells[a] >> b) & 1) && !(grid[a][b] & CELL_REVEALED)) {
+                        at(i, j, 0x90);
+                        at(a, b, 0xA0);
+                        mi = i;
+                        mj = j;
+                    }
+                }
+            }
+        }
+    }
+    at(mi, mj, 0x90);
+    d = dump();
+    printf("chord on a wrong flag at %d,%d: lost %d\n", mi, mj, d[3]);
+    runMs(5000);
+    frame("chord_lost");
+
+    sendRx({0xB1, 0x02, 0x03});
+    runMs(1000);
+    d = dump();
+    printf("reseed: state %d revealed %d stale %d\n", d[3], d[4], stale());
+    std::vector<uint8_t> batch;
+    for (int i = 0; i < boardRows; ++i) {
+        for (int j = 0; j < boardCols; ++j) {
+            if ((mineCells[i] >> j) & 1) { continue; }
+            batch.push_back(0x80 | i);
+            batch.push_back(j);
+            batch.push_back(0x90);
+            if (batch.size() > 50) {
+                sendRx(batch);
+                dump();
+                batch.clear();
+            }
+        }
+    }
+    sendRx(batch);
+    d = dump();
+    printf("won: state %d revealed %d clicks %d 3bv %d\n", d[3], d[4], d[6], d[7]);
+    runMs(6000);
+    printf("stale after the win %d busy %d\n", stale(), animBusy());
+    frame("chord_won");
+}
@@ -0,0 +1,36 @@
+// COMMAND_MODE: a scripted client plays through the dump, wins, reseeds, loses and reseeds again
+#include "common.h"
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    runMs(2100);
+    show("boot");
+
+    // move to 3,0 and reveal, move to 5,5 and flag, as one batch
+    sendRx({0x83, 0x00, 0x90, 0x85, 0x05, 0xA0});
+    show("batch");
+    frame("batch");
+
+    // unflag, then reveal every safe cell known from the dump, a dump per batch
+    sendRx({0x85, 0x05, 0xA0});
+    std::vector<uint8_t> d = dump();
+    uint16_t start = sysTime;
+    int actions = clearBoard(d, boardCols);
+    printf("after %d actions in %u ms: state %d revealed %d\n", actions, (uint16_t)(sysTime - start), d[3], d[4]);
+    expect(d[3] == 2, "the client didn't win");
+    runMs(3000);
+    frame("won");
+
+    // reseed from the won screen
+    sendRx({0xB0, 0x12, 0x34});
+    runMs(500);
+    show("reseed");
+    sendRx({0x81, 0x01, 0x90});
+    runMs(3000);
+    show("reveal 1,1");
+    sendRx({0xB0, 0x12, 0x35});
+    runMs(2000);
+    show("reseed after");
+    frame("end");
+}
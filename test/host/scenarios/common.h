@@ -0,0 +1,75 @@
+// helpers the scenarios share
+#pragma once
+
+void press() {
+    setInput(1, 1, true);
+    runMs(90);
+    setInput(1, 1, false);
+    runMs(60);
+}
+
+void longPress() {
+    setInput(1, 1, true);
+    runMs(400);
+    setInput(1, 1, false);
+    runMs(60);
+}
+
+// walks the cursor there one joystick push at a time
+void moveTo(int x, int y) {
+    while (gridX != x || gridY != y) {
+        setInput(x > gridX ? 2 : x < gridX ? 0 : 1, y > gridY ? 2 : y < gridY ? 0 : 1, false);
+        runMs(90);
+        setInput(1, 1, false);
+        runMs(200);
+    }
+}
+
+#ifdef COMMAND_MODE
+// sends CMD_DUMP and returns the reply: header, cursor x and y, state, revealed, flags, clicks,
+// 3BV, then a byte per cell
+std::vector<uint8_t> dump() {
+    serialOut.clear();
+    sendRx({0xC0});
+    runMs(50);
+    // with -DBUS_TIME long LCD ticks can push the Game tick that takes the command further back,
+    // with -DUART_TIME a large board's reply takes a few ticks more
+    for (int ms = 0; (serialOut.empty() || dumpCo != CO_DONE) && ms < 1000; ++ms) { runMs(1); }
+    drainTx();
+    return std::vector<uint8_t>(serialOut.begin(), serialOut.end());
+}
+
+void show(const char *what) {
+    std::vector<uint8_t> d = dump();
+    printf("%s: %zu bytes hdr %02x cur %d,%d state %d revealed %d flags %d clicks %d 3bv %d\n", what, d.size(), d[0], d[1],
+           d[2], d[3], d[4], d[5], d[6], d[7]);
+}
+
+// CMD_MOVE to the cell then cmd (0x90 reveal, 0xA0 flag)
+void at(int i, int j, uint8_t cmd) { sendRx({(uint8_t)(0x80 | i), (uint8_t)j, cmd}); }
+
+// reveals every safe cell the dump shows as covered, 60 command bytes per batch, until the game
+// ends or nothing is left, returns the number of commands sent
+int clearBoard(std::vector<uint8_t> &d, int n) {
+    int actions = 0;
+    for (bool more = true; more && d[3] == 0;) {
+        more = false;
+        std::vector<uint8_t> batch;
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                uint8_t c = d[8 + i * n + j];
+                if ((c & 15) != 4 && !(c & 0x30) && batch.size() < 60) {
+                    batch.push_back(0x80 | i);
+                    batch.push_back(j);
+                    batch.push_back(0x90);
+                    actions += 2;
+                    more = true;
+                }
+            }
+        }
+        sendRx(batch);
+        d = dump();
+    }
+    return actions;
+}
+#endif
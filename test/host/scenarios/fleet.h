@@ -0,0 +1,156 @@
+// a fleet of virtual devices for load tests: every device is a forked copy of the harness, so the
+// firmware's globals are its own, with its own board seed, clock and scripted joystick input in
+// one of a few play patterns, the parent runs FLEET_JOBS of them at a time and sums them up
+// built with -DBUS_TIME: a tick whose bus bytes take longer than the GCD period would have
+// made TimerISR() skip the next scheduler tick(s), those are counted as overruns
+// environment: FLEET_DEVICES (default 96), FLEET_SECONDS (default 60), FLEET_JOBS (default 8)
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "common.h"
+
+enum { PATTERN_WALKER, PATTERN_SWEEPER, PATTERN_FLAGGER, PATTERNS };
+static const char *const patternNames[PATTERNS] = {"walker", "sweeper", "flagger"};
+
+struct deviceResult {
+    bool done;
+    uint8_t outcome; // 0 still playing, 1 lost, 2 won
+    uint16_t revealed;
+    uint16_t dropped;
+    long busBytes;
+    long maxTick;
+    long overruns;
+    long ms;
+};
+
+static uint32_t rng;
+static uint32_t nextRandom() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static long deviceMs = 0, deviceOverruns = 0, deviceLimit = 0;
+
+// runs the device's clock, counting the ticks the bus would have pushed past the GCD period
+static void deviceRun(int ms) {
+    for (int i = 0; i < ms && deviceMs < deviceLimit; i++, deviceMs++) {
+        long before = busBytes;
+        runMs(1);
+        long us = (busBytes - before) * 5 / 2; // 2.5 us per byte, as in the LCD model
+        deviceOverruns += us / (GCD_PERIOD * 1000);
+    }
+}
+
+static bool deviceOver() { return deviceMs >= deviceLimit || ((gameLost || gameWon) && !animBusy()); }
+
+static void deviceInput(int xZone, int yZone, bool press, int holdMs, int releaseMs) {
+    setInput(xZone, yZone, press);
+    deviceRun(holdMs);
+    setInput(1, 1, false);
+    deviceRun(releaseMs);
+}
+
+// steps the cursor to (x, y) one push at a time, then presses there
+static void deviceVisit(int x, int y, bool flag) {
+    while ((gridX != x || gridY != y) && !deviceOver()) {
+        deviceInput(x > gridX ? 2 : x < gridX ? 0 : 1, y > gridY ? 2 : y < gridY ? 0 : 1, false, 90, 120);
+    }
+    deviceInput(1, 1, true, flag ? 400 : 90, 60);
+}
+
+static void device(int id, deviceResult *r) {
+    rng = 0x9E3779B9u ^ (id * 2654435761u);
+    nextRandom();
+    boardSeed = (nextRandom() & 0xFFFF) | 1;
+    deviceLimit = atol(getenv("FLEET_SECONDS") ? getenv("FLEET_SECONDS") : "60") * 1000;
+    setInput(1, 1, false);
+    boot();
+    deviceRun(2100);
+
+    int pattern = id % PATTERNS;
+    int next = 0;
+    while (!deviceOver()) {
+        uint32_t roll = nextRandom();
+        if (pattern == PATTERN_WALKER) {
+            // wanders, pressing now and then
+            if (roll % 4 == 0) {
+                deviceInput(1, 1, true, 90, 60);
+            } else {
+                deviceInput(roll % 3, (roll >> 4) % 3, false, 90, 120 + (roll >> 8) % 400);
+            }
+        } else if (pattern == PATTERN_SWEEPER) {
+            // presses every cell in order, as fast as the debounce allows
+            deviceVisit(next / boardCols, next % boardCols, false);
+            next = (next + 1) % (boardRows * boardCols);
+        } else {
+            // flags and unflags random cells, reveals a few, with long pauses between
+            deviceVisit(roll % boardRows, (roll >> 8) % boardCols, roll % 5 != 0);
+            deviceRun((roll >> 16) % 2000);
+        }
+    }
+
+    r->outcome = gameWon ? 2 : gameLost ? 1 : 0;
+    r->revealed = cellsRevealed;
+    r->dropped = eventsDropped;
+    r->busBytes = busBytes;
+    r->maxTick = maxTick;
+    r->overruns = deviceOverruns;
+    r->ms = deviceMs;
+    r->done = true;
+}
+
+void scenario() {
+    int devices = atoi(getenv("FLEET_DEVICES") ? getenv("FLEET_DEVICES") : "96");
+    int jobs = atoi(getenv("FLEET_JOBS") ? getenv("FLEET_JOBS") : "8");
+    deviceResult *results = (deviceResult *)mmap(NULL, devices * sizeof(deviceResult), PROT_READ | PROT_WRITE,
+                                                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    expect(results != MAP_FAILED, "no memory for the results");
+    if (results == MAP_FAILED) { return; }
+    memset(results, 0, devices * sizeof(deviceResult));
+
+    fflush(stdout);
+    int running = 0;
+    for (int id = 0; id < devices; ++id) {
+        if (running == jobs) {
+            wait(NULL);
+            running--;
+        }
+        if (fork() == 0) {
+            device(id, &results[id]);
+            _exit(0);
+        }
+        running++;
+    }
+    while (running > 0) {
+        wait(NULL);
+        running--;
+    }
+
+    // sums per pattern, in device order so the output doesn't depend on the job count
+    for (int p = 0; p < PATTERNS; ++p) {
+        long count = 0, crashed = 0, outcomes[3] = {0, 0, 0}, revealed = 0, dropped = 0;
+        long bytes = 0, ms = 0, maxTickAll = 0, overruns = 0;
+        for (int id = p; id < devices; id += PATTERNS) {
+            const deviceResult &r = results[id];
+            count++;
+            if (!r.done) {
+                crashed++;
+                continue;
+            }
+            outcomes[r.outcome]++;
+            revealed += r.revealed;
+            dropped += r.dropped;
+            bytes += r.busBytes;
+            ms += r.ms;
+            overruns += r.overruns;
+            if (r.maxTick > maxTickAll) { maxTickAll = r.maxTick; }
+        }
+        printf("%s: %ld devices, %ld won %ld lost %ld playing, %ld cells revealed\n", patternNames[p], count, outcomes[2],
+               outcomes[1], outcomes[0], revealed);
+        printf("%s: %ld s simulated, %ld bus bytes/s, largest tick %ld bytes, %ld overruns, %ld events dropped\n",
+               patternNames[p], ms / 1000, ms ? bytes * 1000 / ms : 0, maxTickAll, overruns, dropped);
+        expect(crashed == 0, "a device didn't finish");
+    }
+}
@@ -0,0 +1,41 @@
+// COMMAND_MODE: a reveal floods only from the cells it picked, an opening made earlier doesn't
+// spread into a flag taken off since
+#include "common.h"
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    runMs(2100);
+    // two empty cells side by side: flag the right one, reveal the left, take the flag off
+    for (int i = 0; i < boardRows; ++i) {
+        for (int j = 0; j + 1 < boardCols; ++j) {
+            if (!((emptyCells[i] >> j) & 1) || !((emptyCells[i] >> (j + 1)) & 1)) { continue; }
+            at(i, j + 1, 0xA0);
+            at(i, j, 0x90);
+            dump();
+            printf("flagged %d,%d, revealed %d\n", i, j + 1, cellsRevealed);
+            at(i, j + 1, 0xA0);
+            dump();
+
+            // then reveal a covered number somewhere else
+            int ni = -1, nj = -1;
+            for (int a = 0; a < boardRows && ni < 0; ++a) {
+                for (int b = 0; b < boardCols && ni < 0; ++b) {
+                    if (!((mineCells[a] >> b) & 1) && !(grid[a][b] & CELL_REVEALED) && (grid[a][b] & CELL_STATUS) &&
+                        (a != i || b != j + 1)) {
+                        ni = a;
+                        nj = b;
+                    }
+                }
+            }
+            at(ni, nj, 0x90);
+            dump();
+            bool spread = grid[i][j + 1] & CELL_REVEALED;
+            printf("revealed %d,%d: total %d, unflagged cell revealed %d\n", ni, nj, cellsRevealed, spread);
+            expect(!spread, "the reveal flooded from an older opening");
+            runMs(1000);
+            frame("flood");
+            return;
+        }
+    }
+}
@@ -0,0 +1,31 @@
+// the panel drops to idle and partial mode once input stops, and wakes on the next event
+// built with -DLOG_PWR, which logs the power commands the LCD model sees
+#include "common.h"
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    runMs(2100);
+    long start = busBytes;
+    runMs(5000);
+    printf("5 s awake, no input: idle %d, %ld bus bytes\n", lcdIdle, busBytes - start);
+    runMs(5500);
+    printf("after 10.5 s: idle %d\n", lcdIdle);
+    start = busBytes;
+    runMs(5000);
+    printf("5 s idle: %ld bus bytes\n", busBytes - start);
+    runMs(70000);
+    printf("80 s later: idle %d\n", lcdIdle);
+
+    setInput(2, 1, false);
+    runMs(60);
+    setInput(1, 1, false);
+    runMs(60);
+    printf("after a move: idle %d cursor %d,%d\n", lcdIdle, gridX, gridY);
+    press();
+    runMs(1000);
+    printf("revealed %d idle %d\n", cellsRevealed, lcdIdle);
+    runMs(12000);
+    printf("12 s later: idle %d busy %d\n", lcdIdle, animBusy());
+    frame("idle");
+}
@@ -0,0 +1,28 @@
+// a new board wakes the panel like input does, CMD_ZOOM and CMD_RESEED push no input event, and
+// the next idle spell drives the lines of the board as it is then, started on the smallest
+// board (-DZOOM_DEFAULT=2) so the lines the zoomed-out board needs are not all among them
+// built with -DLOG_PWR, which logs the power commands the LCD model sees
+#include "common.h"
+
+static void idleFor(const char *what, int ms) {
+    runMs(ms);
+    printf("%s: idle %d, board %dx%d at %d,%d pitch %d\n", what, lcdIdle, boardRows, boardCols, boardX0, boardY0,
+           cellPitch);
+}
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    idleFor("12 s after boot", 12000);
+
+    sendRx({0x80 | CMD_ZOOM << 4 | 0});
+    idleFor("CMD_ZOOM 0", 200);
+    expect(!lcdIdle, "the zoom left the panel idle");
+    idleFor("11 s later", 11000);
+    frame("zoomed");
+
+    sendRx({0x80 | CMD_RESEED << 4 | 1, 2, 3});
+    idleFor("CMD_RESEED", 200);
+    expect(!lcdIdle, "the new board left the panel idle");
+    idleFor("11 s later", 11000);
+}
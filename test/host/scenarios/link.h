@@ -0,0 +1,209 @@
+// VERSUS_MODE end to end: this process and a fork of it are two devices with a socketpair for
+// the cable, they settle on a seed, play a scripted game and must each end up showing the
+// other's board as it is, the link's load is reported in messages per second and the lag from
+// the uart_send() of a header to the linkPoll() that takes it
+// both sides send at the link's baud rate (-DUART_TIME) and move in step, a ms at a time, so
+// the numbers are simulated ms and don't depend on the host
+// B powers up 17 ms after A, so their ticks are out of phase as two devices' would be
+// side A prints first, then side B, each line starts with its side
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "common.h"
+
+static int cable = -1;
+static bool sideB = false;
+static long linkNow = 0;
+
+// what one side puts on the cable in a ms: the bytes that went out, each with the ms it was
+// queued in, and how many meet() points of the script the side has reached
+struct cableFrame {
+    uint8_t phase;
+    uint8_t n;
+    uint8_t bytes[8];
+    long queued[8];
+};
+
+static long txQueued[UART_TX_SIZE], rxQueued[UART_RX_SIZE];
+static uint8_t txStamped = 0, txSent = 0, rxTaken = 0;
+static uint8_t ownPhase = 0, sentPhase = 0, peerPhase = 0;
+static bool powered = false; // bytes that come in before boot() are lost
+static long messages = 0, lagSum = 0, lagMax = 0, statsFrom = 0;
+
+static void cableRead(void *p, size_t n) {
+    for (size_t got = 0; got < n;) {
+        ssize_t r = read(cable, (char *)p + got, n - got);
+        if (r <= 0) {
+            printf("%c: FAIL the other side went away\n", sideB ? 'B' : 'A');
+            exit(1);
+        }
+        got += r;
+    }
+}
+
+// afterMs: ships what the UART sent in the ms, feeds the RX interrupt what the other side sent
+// in it, and times the headers linkPoll() took
+static void cableStep() {
+    linkNow++;
+    for (; txStamped != uartTxHead; txStamped = (txStamped + 1) & (UART_TX_SIZE - 1)) { txQueued[txStamped] = linkNow; }
+
+    cableFrame out = {}, in;
+    expect(serialOut.size() <= sizeof out.bytes, "more bytes in a ms than the baud rate allows");
+    out.phase = ownPhase;
+    out.n = serialOut.size();
+    for (uint8_t k = 0; k < out.n; ++k) {
+        out.bytes[k] = serialOut[k];
+        out.queued[k] = txQueued[txSent];
+        txSent = (txSent + 1) & (UART_TX_SIZE - 1);
+    }
+    serialOut.clear();
+    sentPhase = ownPhase;
+    if (write(cable, &out, sizeof out) != (ssize_t)sizeof out) { exit(1); }
+    cableRead(&in, sizeof in);
+    peerPhase = in.phase;
+
+    for (; rxTaken != uartRxTail; rxTaken = (rxTaken + 1) & (UART_RX_SIZE - 1)) {
+        if (uartRxBuf[rxTaken] & 0x80) {
+            long lag = linkNow - rxQueued[rxTaken];
+            messages++;
+            lagSum += lag;
+            if (lag > lagMax) { lagMax = lag; }
+        }
+    }
+    for (uint8_t k = 0; k < in.n && powered; ++k) {
+        rxQueued[uartRxHead] = in.queued[k];
+        sendRx({in.bytes[k]});
+    }
+}
+
+// messages taken since the last call, per second of simulated time, and their lag
+static void linkStats(const char *what) {
+    printf("%c %s: %ld messages, %.1f/s, lag %.1f ms average, %ld ms at most\n", sideB ? 'B' : 'A', what, messages,
+           messages * 1000.0 / (linkNow - statsFrom), messages ? (double)lagSum / messages : 0.0, lagMax);
+    messages = lagSum = lagMax = 0;
+    statsFrom = linkNow;
+}
+
+static uint32_t minesHash() {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < boardRows; ++i) { h = (h ^ mineCells[i]) * 16777619u; }
+    return h;
+}
+
+// what a side has on its own board, for the other to check its view against
+struct cableSummary {
+    uint16_t revealed[MAX_ROWS];
+    uint16_t flagged[MAX_ROWS];
+    uint8_t cells;
+    uint8_t x, y;
+    uint16_t seed;
+};
+
+// waits for the other side to get to the same point of its script, both go on after the same
+// ms, so what linkStats() prints next covers the same time on both
+static void meet() {
+    ownPhase++;
+    while (sentPhase != ownPhase || peerPhase != ownPhase) { runMs(1); }
+}
+
+// ends the script, trades summaries and checks the opponent state linkApply() built up
+static void finish() {
+    meet();
+    afterMs = 0;
+
+    cableSummary own = {}, peer;
+    for (int i = 0; i < boardRows; ++i) {
+        for (int j = 0; j < boardCols; ++j) {
+            if (grid[i][j] & CELL_REVEALED) { own.revealed[i] |= 1U << j; }
+            if (grid[i][j] & CELL_FLAGGED) { own.flagged[i] |= 1U << j; }
+        }
+    }
+    own.cells = cellsRevealed;
+    own.x = gridX;
+    own.y = gridY;
+    own.seed = linkSeed;
+    if (write(cable, &own, sizeof own) != (ssize_t)sizeof own) { exit(1); }
+    cableRead(&peer, sizeof peer);
+
+    bool same = true;
+    for (int i = 0; i < boardRows; ++i) {
+        if (oppRevealed[i] != peer.revealed[i] || oppFlagged[i] != peer.flagged[i]) { same = false; }
+    }
+    expect(same, "the opponent's cells differ from the opponent's board");
+    expect(oppCellsRevealed == peer.cells, "the opponent's count differs from the opponent's");
+    expect(oppX == peer.x && oppY == peer.y, "the opponent's cursor is elsewhere");
+    expect(linkSeed == peer.seed, "the sides are on different boards");
+    expect(uartRxDropped == 0, "the RX buffer overflowed");
+    printf("%c: ends with %d cells revealed, the opponent %d, it is at %d,%d\n", sideB ? 'B' : 'A', cellsRevealed,
+           oppCellsRevealed, oppX, oppY);
+}
+
+void scenario() {
+    int fds[2], out[2];
+    fflush(stdout);
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0 || pipe(out) != 0) { exit(1); }
+    pid_t other = fork();
+    sideB = (other == 0);
+    cable = fds[sideB ? 1 : 0];
+    close(fds[sideB ? 0 : 1]);
+    if (sideB) {
+        // B prints into a pipe that A copies out once it is done
+        dup2(out[1], 1);
+        boardSeed = 0x1234;
+    }
+    close(out[1]);
+    const char me = sideB ? 'B' : 'A';
+
+    afterMs = cableStep;
+    for (int ms = 0; sideB && ms < 17; ++ms) { cableStep(); }
+    setInput(1, 1, false);
+    powered = true;
+    boot();
+    runMs(2100);
+    meet();
+    printf("%c: seed %04x, mines %08x, %u bytes dropped\n", me, linkSeed, (unsigned)minesHash(), uartRxDropped);
+    linkStats("seeds");
+
+    // A opens the first empty cell, B the last, then flags the first mine
+    int cell = -1;
+    for (int k = 0; k < boardRows * boardCols; ++k) {
+        int c = sideB ? boardRows * boardCols - 1 - k : k;
+        if ((emptyCells[c / boardCols] >> (c % boardCols)) & 1) {
+            cell = c;
+            break;
+        }
+    }
+    moveTo(cell / boardCols, cell % boardCols);
+    press();
+    if (sideB) {
+        for (int c = 0; c < boardRows * boardCols; ++c) {
+            if (((mineCells[c / boardCols] >> (c % boardCols)) & 1) && !(grid[c / boardCols][c % boardCols] & CELL_REVEALED)) {
+                moveTo(c / boardCols, c % boardCols);
+                longPress();
+                break;
+            }
+        }
+    }
+    runMs(200);
+    meet();
+    linkStats("openings");
+    frame(sideB ? "b-openings" : "a-openings");
+
+    // then both sweep the cursor corner to corner and back
+    moveTo(boardRows - 1, boardCols - 1);
+    moveTo(0, 0);
+    runMs(200);
+    meet();
+    linkStats("sweep");
+    frame(sideB ? "b-sweep" : "a-sweep");
+
+    finish();
+    if (sideB) { return; }
+
+    int status = 0;
+    waitpid(other, &status, 0);
+    expect(WIFEXITED(status) && WEXITSTATUS(status) == 0, "side B failed");
+    fflush(stdout);
+    char buf[4096];
+    for (ssize_t n; (n = read(out[0], buf, sizeof buf)) > 0;) { fwrite(buf, 1, n, stdout); }
+}
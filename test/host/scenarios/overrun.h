@@ -0,0 +1,51 @@
+// TASK_STATS with the bus timed (-DBUS_TIME): the timer vector fires inside the ticks that run
+// past the next ms, as on the device, so the boot tick that runs past the GCD period must show
+// up as an overrun of the LCD task, and sysTime must keep up with the clock through it
+// the main loop doesn't run on the host, the scenario takes the reports in its place
+#include "common.h"
+
+static const char *const taskNames[NUM_TASKS] = {"lcd", "joystick", "game"};
+
+// prints the report TimerISR() handed over, if there is one, returns the overruns in it
+static long takeReport() {
+    if (!reportReady) { return 0; }
+    long overruns = 0;
+    printf("report:");
+    for (uint8_t i = 0; i < NUM_TASKS; i++) {
+        printf(" %s %u/%u", taskNames[i], report.ticks[i], report.overruns[i]);
+        overruns += report.overruns[i];
+    }
+    printf("\n");
+    reportReady = false;
+    return overruns;
+}
+
+// sysTime against the clock the harness keeps, they may differ by the ms the tick in progress
+static void clockCheck(const char *when) {
+    long lag = clockNow / 2000 - sysTime;
+    printf("%s: sysTime %u, clock %ld ms\n", when, sysTime, clockNow / 2000);
+    expect(lag >= 0 && lag < (long)GCD_PERIOD, "sysTime fell behind the clock");
+}
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    long overruns = 0;
+    for (int s = 0; s < 3; ++s) {
+        runMs(1000);
+        overruns += takeReport();
+    }
+    printf("boot: largest tick %ld bus bytes, %ld overruns\n", maxTick, overruns);
+    expect(overruns > 0, "the boot tick ran past the GCD period without an overrun");
+    clockCheck("boot");
+
+    // a forced redraw stays within the render budget, so it costs no overruns
+    drawInvalidate();
+    overruns = 0;
+    for (int s = 0; s < 2; ++s) {
+        runMs(1000);
+        overruns += takeReport();
+    }
+    expect(overruns == 0, "a budgeted redraw overran");
+    clockCheck("redraw");
+}
@@ -0,0 +1,42 @@
+// render throughput with the bus timed (-DBUS_TIME, 2.5 us per SPI byte): no LCD tick may send
+// much more than its LCD_BUDGET_US worth of bytes, and a forced full redraw must end on the
+// same frame it started from
+#include "common.h"
+
+// bytes the budget lets through, plus one cell draw or fill slice that starts just inside it
+static const long TICK_LIMIT = LCD_BUDGET_US * 2 / 5 + 1500;
+
+static bool redrawing() {
+    for (uint8_t i = 0; i < MAX_ROWS; ++i) {
+        if (drawPending[i]) { return true; }
+    }
+    return false;
+}
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    runMs(2100);
+    printf("boot: largest tick %ld bus bytes\n", maxTick);
+    expect(maxTick <= TICK_LIMIT, "a boot tick went over the render budget");
+    frame("boot");
+
+    moveTo(3, 0);
+    press();
+    runMs(1500);
+    frame("play");
+
+    uint32_t before = frameHash();
+    maxTick = 0;
+    long start = busBytes;
+    int ms = 0;
+    drawInvalidate();
+    do {
+        runMs(LCD_PERIOD);
+        ms += LCD_PERIOD;
+    } while (redrawing() && ms < 5000);
+    printf("forced redraw: %ld bus bytes over %d ms, largest tick %ld\n", busBytes - start, ms, maxTick);
+    expect(maxTick <= TICK_LIMIT, "a redraw tick went over the render budget");
+    expect(frameHash() == before, "the redraw changed the frame");
+    frame("redrawn");
+}
@@ -0,0 +1,110 @@
+// a session recorded to EEPROM (-DINPUT_MODE=INPUT_RECORD) and played back by another build
+// (-DINPUT_MODE=INPUT_REPLAY) must show the same frames: both builds run this script, the joystick
+// only reaches the recording one, which saves the EEPROM and its frame hashes to $HOST_TMP for
+// the replaying one, so record runs first
+// at the end the EEPROM stalls during an input burst, the recording must stop at the last event
+// it queued whole and still play back to the end
+#include "common.h"
+
+#if INPUT_MODE == INPUT_RECORD
+static const char *const modeName = "record";
+#else
+static const char *const modeName = "replay";
+#endif
+
+static std::vector<uint32_t> hashes;
+
+static std::string sessionPath(const char *what) {
+    const char *dir = getenv("HOST_TMP");
+    return std::string(dir && *dir ? dir : ".") + "/replay-session." + what;
+}
+
+static void checkpoint(const char *name) {
+    frame(name);
+    hashes.push_back(frameHash());
+}
+
+// moveTo() with a bound, a replay that went astray mustn't walk forever
+static void walkTo(int x, int y) {
+    for (int n = 0; n < 40 && (gridX != x || gridY != y); ++n) {
+        setInput(x > gridX ? 2 : x < gridX ? 0 : 1, y > gridY ? 2 : y < gridY ? 0 : 1, false);
+        runMs(90);
+        setInput(1, 1, false);
+        runMs(200);
+    }
+}
+
+void scenario() {
+    FILE *f;
+#if INPUT_MODE == INPUT_REPLAY
+    // the seed must come from the recording
+    boardSeed = 0x1111;
+    f = fopen(sessionPath("eeprom").c_str(), "rb");
+    bool loaded = f && fread(eeprom, 1, sizeof eeprom, f) == sizeof eeprom;
+    if (f) { fclose(f); }
+    expect(loaded, "no recorded session, run record first");
+    if (!loaded) { return; }
+#endif
+    setInput(1, 1, false);
+    boot();
+    runMs(2100);
+    printf("%s: seed %04x\n", modeName, linkSeed);
+    checkpoint("start");
+
+    // open the first empty cell, flag a mine on the edge of the opening, walk back to the corner
+    int cell = 0;
+    while (!((emptyCells[cell / boardCols] >> (cell % boardCols)) & 1)) { cell++; }
+    walkTo(cell / boardCols, cell % boardCols);
+    press();
+    runMs(500);
+    checkpoint("opened");
+    for (int c = 0; c < boardRows * boardCols; ++c) {
+        int i = c / boardCols, j = c % boardCols;
+        if (((mineCells[i] >> j) & 1) && ((i > 0 && (grid[i - 1][j] & CELL_REVEALED)) ||
+                                           (i + 1 < boardRows && (grid[i + 1][j] & CELL_REVEALED)))) {
+            walkTo(i, j);
+            longPress();
+            break;
+        }
+    }
+    checkpoint("flagged");
+    walkTo(0, 0);
+    checkpoint("walked");
+    printf("%s: %d revealed, %d flags, cursor %d,%d, %u events\n", modeName, cellsRevealed, flagsPlaced, gridX, gridY,
+           replayNumEvents);
+
+    // a burst of joystick changes while the EEPROM takes no writes, a change every other joystick
+    // tick fills the write queue, the recording ends there and its count is written once it drains
+    eeReady = 0;
+    for (int k = 0; k < 200 && !replayFinished; ++k) {
+        setInput(k & 1 ? 1 : 2, 1, false);
+        runMs(60);
+    }
+    setInput(1, 1, false);
+    eeReady = 1;
+    runMs(1000);
+
+#if INPUT_MODE == INPUT_RECORD
+    printf("record: the stalled EEPROM ended the recording at %u events\n", replayNumEvents);
+    expect(replayFinished, "the burst didn't fill the write queue");
+    expect(replayQueueHead == replayQueueTail, "the write queue didn't drain");
+    expect(eeprom_read_word(&replayCount) == replayNumEvents, "the EEPROM holds another count");
+    f = fopen(sessionPath("eeprom").c_str(), "wb");
+    if (f) {
+        fwrite(eeprom, 1, sizeof eeprom, f);
+        fclose(f);
+    }
+    f = fopen(sessionPath("frames").c_str(), "w");
+    for (size_t k = 0; f && k < hashes.size(); ++k) { fprintf(f, "%08x\n", hashes[k]); }
+    if (f) { fclose(f); }
+#else
+    printf("replay: played %u of %u events\n", replayPos, replayNumEvents);
+    expect(replayPos == replayNumEvents, "the replay didn't get through the recording");
+    f = fopen(sessionPath("frames").c_str(), "r");
+    unsigned h;
+    for (size_t k = 0; k < hashes.size(); ++k) {
+        expect(f && fscanf(f, "%x", &h) == 1 && h == hashes[k], "a replayed frame differs from the recorded one");
+    }
+    if (f) { fclose(f); }
+#endif
+}
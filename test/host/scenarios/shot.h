@@ -0,0 +1,74 @@
+// COMMAND_MODE: CMD_SHOT rebuilds the screen from what the renderer drew, the decoded reply
+// must match the LCD model pixel for pixel
+#include "common.h"
+
+// the panel when the reply started: the HUD rows go out first, and the timer can tick over
+// while the rest of the reply is still on its way
+static uint16_t shown[320][320];
+
+// sends CMD_SHOT and waits for the reply to stop growing
+static void request() {
+    serialOut.clear();
+    sendRx({0xE0});
+    while (serialOut.empty()) { runMs(1); }
+    memcpy(shown, fb, sizeof(shown));
+    size_t last = 0;
+    for (int t = 0; t < 20000; t += 50) {
+        runMs(50);
+        drainTx();
+        if (serialOut.size() == last) { return; }
+        last = serialOut.size();
+    }
+}
+
+// decodes the reply (see CMD_SHOT) and counts the pixels that differ from the panel
+static void shot(const char *name) {
+    request();
+    const uint8_t *p = (const uint8_t *)serialOut.data();
+    int w = (p[1] << 8) | p[2], h = (p[3] << 8) | p[4];
+    uint16_t palette[8];
+    for (int k = 0; k < 8; ++k) { palette[k] = (p[5 + 2 * k] << 8) | p[6 + 2 * k]; }
+    long pixel = 0, wrong = 0;
+    for (size_t k = 21; k < serialOut.size() && pixel < (long)w * h; ++k) {
+        for (int n = (p[k] >> 3) + 1; n > 0 && pixel < (long)w * h; --n, ++pixel) {
+            wrong += palette[p[k] & 7] != shown[Display::y0 + pixel / w][Display::x0 + pixel % w];
+        }
+    }
+    printf("%s: %d x %d in %zu bytes, %ld pixels decoded, %ld differ from the panel\n", name, w, h, serialOut.size(),
+           pixel, wrong);
+    expect(pixel == (long)w * h && wrong == 0, "the screenshot doesn't match the panel");
+    frame(name);
+}
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    runMs(2100);
+    shot("shot_boot");
+
+    std::vector<uint8_t> d = dump();
+    int n = zoomLevels[d[0] & 15].rows;
+    std::vector<uint8_t> batch;
+    for (int k = 0; k < 6; ++k) {
+        int i = (k * 5) % n, j = (k * 3) % n;
+        if ((d[8 + i * n + j] & 15) != 4) {
+            batch.push_back(0x80 | i);
+            batch.push_back(j);
+            batch.push_back(0x90);
+        }
+    }
+    batch.push_back(0x80 | 2);
+    batch.push_back(2);
+    batch.push_back(0xA0);
+    sendRx(batch);
+    runMs(3000);
+    shot("shot_play");
+
+    // a dump queued behind a screenshot comes out after it, whole
+    serialOut.clear();
+    sendRx({0xE0, 0xC0});
+    runMs(8000);
+    drainTx();
+    printf("shot then dump: %zu bytes, dump header %02x\n", serialOut.size(),
+           (uint8_t)serialOut[serialOut.size() - 8 - n * n]);
+}
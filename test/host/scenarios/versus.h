@@ -0,0 +1,84 @@
+// VERSUS_MODE: what a chord tells the opponent, only the neighbours it uncovered, or the mine a
+// wrong flag set off, played on the joystick with nobody on the other end of the link
+#include "common.h"
+
+// the LINK_REVEAL messages sent since the last call
+static void reveals(const char *what) {
+    drainTx();
+    printf("%s:", what);
+    for (size_t k = 0; k + 1 < serialOut.size(); ++k) {
+        uint8_t b = serialOut[k];
+        if ((b & 0xF0) == (0x80 | LINK_REVEAL << 4)) {
+            int i = b & 0x0F, j = serialOut[k + 1];
+            printf(" %d,%d%s", i, j, ((mineCells[i] >> j) & 1) ? "(mine)" : "");
+        }
+    }
+    printf("\n");
+    serialOut.clear();
+}
+
+// a covered number with a covered safe neighbour, away from the edges
+static bool findNumber(int *x, int *y, int *sx, int *sy) {
+    for (int i = 1; i < boardRows - 1; ++i) {
+        for (int j = 1; j < boardCols - 1; ++j) {
+            uint8_t s = grid[i][j] & CELL_STATUS;
+            if (s < 1 || s > 2 || (grid[i][j] & CELL_REVEALED)) { continue; }
+            for (int a = i - 1; a <= i + 1; ++a) {
+                for (int b = j - 1; b <= j + 1; ++b) {
+                    if ((a != i || b != j) && !((mineCells[a] >> b) & 1) && !(grid[a][b] & CELL_REVEALED)) {
+                        *x = i;
+                        *y = j;
+                        *sx = a;
+                        *sy = b;
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    runMs(2100);
+    serialOut.clear();
+
+    int x, y, sx, sy;
+    findNumber(&x, &y, &sx, &sy);
+    moveTo(x, y);
+    press();
+    serialOut.clear();
+    press();
+    reveals("chord without its flags");
+
+    for (int i = x - 1; i <= x + 1; ++i) {
+        for (int j = y - 1; j <= y + 1; ++j) {
+            if ((mineCells[i] >> j) & 1) {
+                moveTo(i, j);
+                longPress();
+            }
+        }
+    }
+    moveTo(x, y);
+    serialOut.clear();
+    press();
+    reveals("chord");
+    press();
+    reveals("chord again");
+
+    // the right number of flags, one of them on a safe cell
+    findNumber(&x, &y, &sx, &sy);
+    moveTo(x, y);
+    press();
+    moveTo(sx, sy);
+    longPress();
+    moveTo(x, y);
+    serialOut.clear();
+    press();
+    reveals("chord on a wrong flag");
+    printf("lost %d\n", gameLost);
+    runMs(3000);
+    frame("lost");
+}
@@ -0,0 +1,38 @@
+// COMMAND_MODE: every zoom level of the panel, its board size, the cost of switching to it and
+// a game cleared on it
+#include "common.h"
+
+// the screen fill or cells still waiting for the renderer
+bool drawing() {
+    for (int i = 0; i < MAX_ROWS; ++i) {
+        if (drawPending[i]) { return true; }
+    }
+    return fillCo != CO_DONE;
+}
+
+void scenario() {
+    setInput(1, 1, false);
+    boot();
+    runMs(2100);
+    show("boot");
+    for (int z = 0; z < ZOOM_LEVELS; ++z) {
+        char name[32];
+        long start = busBytes;
+        sendRx({(uint8_t)(0xD0 | z)});
+        runMs(1000);
+        // with -DBUS_TIME a large panel's fill takes longer than that at the render budget
+        for (int ms = 0; drawing() && ms < 5000; ms += 10) { runMs(10); }
+        printf("zoom %d: %ld bus bytes to clear and draw the new board\n", z, busBytes - start);
+        show("new");
+        sprintf(name, "zoom%d_start", z);
+        frame(name);
+
+        std::vector<uint8_t> d = dump();
+        int n = zoomLevels[d[0] & 15].rows;
+        int actions = clearBoard(d, n);
+        printf("zoom %d: %d actions, state %d revealed %d of %d\n", z, actions, d[3], d[4], n * n);
+        runMs(4000);
+        sprintf(name, "zoom%d_end", z);
+        frame(name);
+    }
+}
@@ -0,0 +1,6 @@
+// host stand-in for <util/atomic.h>: a block runs once with the I bit clear, then puts SREG back
+#pragma once
+#include "../avr/interrupt.h"
+
+#define ATOMIC_BLOCK(x) for (uint8_t atomicSreg = SREG, atomicOnce = (cli(), 1); atomicOnce; atomicOnce = 0, SREG = atomicSreg)
+#define ATOMIC_RESTORESTATE
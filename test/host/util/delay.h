@@ -0,0 +1,5 @@
+// host stand-in for <util/delay.h>: delays take no time
+#pragma once
+
+void _delay_ms(double ms);
+void _delay_us(double us);
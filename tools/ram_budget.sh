@@ -0,0 +1,22 @@
+#!/bin/sh
+# per-symbol RAM and flash budget of the firmware, largest first
+# usage: tools/ram_budget.sh [firmware.elf], defaults to the PlatformIO build output
+# run it after each build, e.g. from a PlatformIO post-build action
+
+ELF=${1:-$(ls .pio/build/*/firmware.elf 2>/dev/null | head -n 1)}
+if [ -z "$ELF" ] || [ ! -f "$ELF" ]; then
+    echo "usage: $0 firmware.elf" >&2
+    exit 1
+fi
+
+echo "== sections =="
+avr-size -A "$ELF" | grep -E '^\.(text|data|bss|noinit|eeprom)'
+
+# RAM is .data + .bss (nm types d/D and b/B), flash is everything in .text (t/T, PROGMEM tables included)
+echo
+echo "== RAM (bytes, symbol) =="
+avr-nm -C --size-sort -r -S -t d "$ELF" | awk '$3 ~ /^[bBdD]$/ { size = $2; $1 = $2 = $3 = ""; printf "%6d %s\n", size, $0 }'
+
+echo
+echo "== flash, top 30 (bytes, symbol) =="
+avr-nm -C --size-sort -r -S -t d "$ELF" | awk '$3 ~ /^[tT]$/ { size = $2; $1 = $2 = $3 = ""; printf "%6d %s\n", size, $0 }' | head -n 30
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+# decodes a CMD_SHOT screenshot (firmware built with COMMAND_MODE) and saves it as PNG, or PPM
+# when the output name ends in .ppm
+# usage: tools/screenshot.py reply.bin [--out shot.png] [--scale N]
+#        tools/screenshot.py --port /dev/ttyUSB0 [--out shot.png] [--scale N] [--timeout S]
+# with --port it sends the request itself and reads the reply, giving up after S seconds
+# (10 by default), set the port up first with
+#   stty -F /dev/ttyUSB0 250000 raw
+
+import argparse
+import os
+import select
+import struct
+import sys
+import time
+import zlib
+
+# see CMD_SHOT in include/main.h
+SHOT_HEADER = 0xE0  # LINK_HEADER(CMD_SHOT, 0)
+PALETTE_SIZE = 8
+RUN_MAX = 32
+# the screens of the panels in include/display.h, width x height
+SCREEN_SIZES = {(128, 128), (320, 240)}
+
+
+# the reply isn't all there yet
+class CutShort(ValueError):
+    pass
+
+
+def rgb565(c):
+    r, g, b = (c >> 11) & 0x1F, (c >> 5) & 0x3F, c & 0x1F
+    return (r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2)
+
+
+def decode_at(data, start):
+    # the reply that starts at data[start], None if it can't be one
+    data = data[start + 1:]
+    if len(data) < 4:
+        raise CutShort('screenshot header cut short')
+    w, h = struct.unpack('>HH', data[:4])
+    if (w, h) not in SCREEN_SIZES:
+        return None
+    if len(data) < 4 + 2 * PALETTE_SIZE:
+        raise CutShort('screenshot header cut short')
+    palette = [rgb565(c) for c in struct.unpack('>%dH' % PALETTE_SIZE, data[4:4 + 2 * PALETTE_SIZE])]
+
+    pixels = bytearray()
+    runs = 0
+    for b in data[4 + 2 * PALETTE_SIZE:]:
+        if len(pixels) >= 3 * w * h:
+            break
+        pixels += bytes(palette[b & 7]) * ((b >> 3) + 1)
+        runs += 1
+    if len(pixels) < 3 * w * h:
+        raise CutShort('screenshot cut short, %d of %d pixels' % (len(pixels) // 3, w * h))
+    # the firmware's last run ends on the last pixel, one that runs past it wasn't a reply
+    if len(pixels) > 3 * w * h:
+        return None
+    return w, h, pixels, 5 + 2 * PALETTE_SIZE + runs
+
+
+def decode(data):
+    # the reply can follow bytes of earlier commands, and their bytes can look like its
+    # header, so every header byte is tried until one is followed by a screen that fits
+    start = data.find(bytes([SHOT_HEADER]))
+    short = None
+    while start >= 0:
+        try:
+            shot = decode_at(data, start)
+            if shot is not None:
+                return shot
+        except CutShort as e:
+            # it may still turn out to be the reply once the rest is in
+            short = short or e
+        start = data.find(bytes([SHOT_HEADER]), start + 1)
+    if short is not None:
+        raise short
+    raise ValueError('no screenshot header in the input')
+
+
+def scale(w, h, pixels, n):
+    out = bytearray()
+    for y in range(h):
+        row = pixels[3 * w * y:3 * w * (y + 1)]
+        wide = b''.join(row[3 * x:3 * x + 3] * n for x in range(w))
+        out += wide * n
+    return w * n, h * n, out
+
+
+def save_png(path, w, h, pixels):
+    def chunk(kind, body):
+        return struct.pack('>I', len(body)) + kind + body + struct.pack('>I', zlib.crc32(kind + body) & 0xFFFFFFFF)
+    raw = b''.join(b'\0' + bytes(pixels[3 * w * y:3 * w * (y + 1)]) for y in range(h))
+    with open(path, 'wb') as f:
+        f.write(b'\x89PNG\r\n\x1a\n')
+        f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', w, h, 8, 2, 0, 0, 0)))
+        f.write(chunk(b'IDAT', zlib.compress(raw, 9)))
+        f.write(chunk(b'IEND', b''))
+
+
+def save_ppm(path, w, h, pixels):
+    with open(path, 'wb') as f:
+        f.write(b'P6\n%d %d\n255\n' % (w, h))
+        f.write(bytes(pixels))
+
+
+def request(port, timeout):
+    # reads until the whole screen is in, the header says how much that is
+    fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+    try:
+        os.write(fd, bytes([SHOT_HEADER]))
+        deadline = time.monotonic() + timeout
+        data = b''
+        while True:
+            left = deadline - time.monotonic()
+            if left <= 0 or not select.select([fd], [], [], left)[0]:
+                raise SystemExit('no complete screenshot after %g s, %d bytes received' % (timeout, len(data)))
+            data += os.read(fd, 256)
+            try:
+                return decode(data)
+            except ValueError:
+                # no reply yet, or not all of it
+                continue
+    finally:
+        os.close(fd)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='decode a CMD_SHOT screenshot')
+    ap.add_argument('reply', nargs='?', help="the bytes the firmware sent back, '-' for stdin")
+    ap.add_argument('--port', help='serial port to request the screenshot on instead')
+    ap.add_argument('--out', default='screenshot.png', help='output file, .png or .ppm (default: screenshot.png)')
+    ap.add_argument('--scale', type=int, default=1, help='enlarge every pixel to N x N')
+    ap.add_argument('--timeout', type=float, default=10, help='seconds to wait for the reply on --port (default: 10)')
+    opt = ap.parse_args()
+
+    if opt.port:
+        w, h, pixels, size = request(opt.port, opt.timeout)
+    elif opt.reply:
+        data = sys.stdin.buffer.read() if opt.reply == '-' else open(opt.reply, 'rb').read()
+        try:
+            w, h, pixels, size = decode(data)
+        except ValueError as e:
+            sys.exit(str(e))
+    else:
+        ap.error('give a reply file or --port')
+
+    print('%d x %d, %d bytes (%d raw at 16 bits per pixel)' % (w, h, size, 2 * w * h))
+    if opt.scale > 1:
+        w, h, pixels = scale(w, h, pixels, opt.scale)
+    if opt.out.endswith('.ppm'):
+        save_ppm(opt.out, w, h, pixels)
+    else:
+        save_png(opt.out, w, h, pixels)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,242 @@
+#!/usr/bin/env python3
+# decodes an LCD_CAPTURE stream: replays the ST7735 (or ILI9341) commands and pixel data the
+# firmware sent into a model of the panel's memory, reports the bus traffic of every frame
+# (LCD tick), reports the power mode changes (LCD_IDLE_MS), and saves the screen as PPM
+# usage: tools/st7735_decode.py capture.bin [--panel ili9341] [--out screen.ppm] [--frames DIR] [--golden ref.ppm]
+# capture it with the firmware built with LCD_CAPTURE, e.g.
+#   stty -F /dev/ttyUSB0 1000000 raw && cat /dev/ttyUSB0 > capture.bin
+
+import argparse
+import os
+import sys
+
+# stream framing, see LCD_CAPTURE in include/main.h
+CAPTURE_ESCAPE = 0xFD
+CAPTURE_FRAME = 0xFE
+CAPTURE_COMMAND = 0xFF
+
+SWRESET = 0x01
+PTLON = 0x12
+NORON = 0x13
+CASET = 0x2A
+RASET = 0x2B
+RAMWR = 0x2C
+PTLAR = 0x30
+MADCTL = 0x36
+IDMOFF = 0x38
+IDMON = 0x39
+COLMOD = 0x3A
+
+# controller memory (w, h) and the part of it the panel shows (x0, y0, w, h), see display.h
+PANELS = {
+    'st7735': ((132, 162), (2, 3, 128, 128)),
+    'ili9341': ((240, 320), (0, 0, 320, 240)),
+}
+
+
+def rgb565(c):
+    r, g, b = (c >> 11) & 0x1F, (c >> 5) & 0x3F, c & 0x1F
+    return (r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2)
+
+
+def rgb444(c):
+    return (((c >> 8) & 0x0F) * 17, ((c >> 4) & 0x0F) * 17, (c & 0x0F) * 17)
+
+
+class Panel:
+    def __init__(self, mem_w, mem_h):
+        self.mem_w, self.mem_h = mem_w, mem_h
+        # square, so it holds the screen whichever way MV turns it
+        side = max(mem_w, mem_h)
+        self.mem = [[(0, 0, 0)] * side for _ in range(side)]
+        self.reset()
+
+    def reset(self):
+        self.colmod = 0x06  # 18-bit after reset
+        self.madctl = 0
+        self.xs, self.xe, self.ys, self.ye = 0, self.mem_w - 1, 0, self.mem_h - 1
+        self.cmd = None
+        self.args = []
+        self.pixel = []
+        self.x, self.y = 0, 0
+        self.modes = []  # power mode changes since the last frame report
+
+    def width(self):
+        # MV swaps rows and columns
+        return self.mem_h if self.madctl & 0x20 else self.mem_w
+
+    def height(self):
+        return self.mem_w if self.madctl & 0x20 else self.mem_h
+
+    def command(self, c, stats):
+        stats['commands'] += 1
+        self.cmd = c
+        self.args = []
+        self.pixel = []
+        if c == SWRESET:
+            self.reset()
+        elif c == RAMWR:
+            self.x, self.y = self.xs, self.ys
+            stats['windows'] += 1
+        elif c in (PTLON, NORON, IDMON, IDMOFF):
+            self.modes.append({PTLON: 'partial', NORON: 'normal', IDMON: 'idle on', IDMOFF: 'idle off'}[c])
+
+    def data(self, d, stats):
+        if self.cmd == PTLAR:
+            self.args.append(d)
+            if len(self.args) == 4:
+                self.modes.append('partial lines %d-%d' % (self.args[0] << 8 | self.args[1], self.args[2] << 8 | self.args[3]))
+        elif self.cmd in (CASET, RASET):
+            self.args.append(d)
+            if len(self.args) == 4:
+                a = self.args[0] << 8 | self.args[1]
+                e = self.args[2] << 8 | self.args[3]
+                if self.cmd == CASET:
+                    self.xs, self.xe = a, e
+                else:
+                    self.ys, self.ye = a, e
+        elif self.cmd == MADCTL:
+            self.madctl = d
+        elif self.cmd == COLMOD:
+            self.colmod = d & 0x07
+        elif self.cmd == RAMWR:
+            self.pixel.append(d)
+            if self.colmod == 0x05 and len(self.pixel) == 2:
+                self.put(rgb565(self.pixel[0] << 8 | self.pixel[1]), stats)
+                self.pixel = []
+            elif self.colmod == 0x03 and len(self.pixel) == 3:
+                # two 12-bit pixels in 3 bytes
+                p = self.pixel
+                self.put(rgb444(p[0] << 4 | p[1] >> 4), stats)
+                self.put(rgb444((p[1] & 0x0F) << 8 | p[2]), stats)
+                self.pixel = []
+            elif self.colmod == 0x06 and len(self.pixel) == 3:
+                self.put(tuple(v & 0xFC for v in self.pixel), stats)
+                self.pixel = []
+
+    def put(self, color, stats):
+        stats['pixels'] += 1
+        if self.x < self.width() and self.y < self.height():
+            # the model keeps the screen as the firmware addresses it, MV only changes the bounds
+            if self.mem[self.y][self.x] == color:
+                stats['redundant'] += 1
+            self.mem[self.y][self.x] = color
+        # auto increment across the window, wrapping back to its first pixel
+        self.x += 1
+        if self.x > self.xe:
+            self.x = self.xs
+            self.y += 1
+            if self.y > self.ye:
+                self.y = self.ys
+
+    def save(self, path, view):
+        x0, y0, w, h = view
+        with open(path, 'wb') as f:
+            f.write(b'P6\n%d %d\n255\n' % (w, h))
+            side = len(self.mem)
+            for y in range(y0, y0 + h):
+                row = self.mem[y] if y < side else [(0, 0, 0)] * side
+                f.write(bytes(v for x in range(x0, x0 + w) for v in (row[x] if x < side else (0, 0, 0))))
+
+    def screen(self, view):
+        x0, y0, w, h = view
+        return [self.mem[y][x0:x0 + w] for y in range(y0, y0 + h)]
+
+
+def read_ppm(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    parts = data.split(None, 4)
+    if parts[0] != b'P6':
+        raise ValueError(path + ' is not a binary PPM')
+    w, h = int(parts[1]), int(parts[2])
+    px = parts[4][:w * h * 3]
+    return w, h, [[tuple(px[(y * w + x) * 3:(y * w + x) * 3 + 3]) for x in range(w)] for y in range(h)]
+
+
+def new_stats():
+    return {'bytes': 0, 'commands': 0, 'windows': 0, 'pixels': 0, 'redundant': 0}
+
+
+def main():
+    ap = argparse.ArgumentParser(description='decode an LCD_CAPTURE stream')
+    ap.add_argument('capture', help="capture file, '-' for stdin")
+    ap.add_argument('--out', help='save the final screen as PPM')
+    ap.add_argument('--frames', help='save a PPM of every frame that drew something into this directory')
+    ap.add_argument('--golden', help='compare the final screen with this PPM, exit 1 if it differs')
+    ap.add_argument('--panel', choices=sorted(PANELS), default='st7735',
+                    help='controller the firmware was built for (LCD_ILI9341 = ili9341)')
+    ap.add_argument('--view', help="visible area x0,y0,w,h (default: the panel's, 2,3,128,128 for the st7735)")
+    ap.add_argument('--quiet', action='store_true', help='totals only, no per-frame lines')
+    opt = ap.parse_args()
+
+    mem, view = PANELS[opt.panel]
+    if opt.view:
+        view = tuple(int(v) for v in opt.view.split(','))
+    data = sys.stdin.buffer.read() if opt.capture == '-' else open(opt.capture, 'rb').read()
+    if opt.frames:
+        os.makedirs(opt.frames, exist_ok=True)
+
+    panel = Panel(*mem)
+    frame = new_stats()
+    total = new_stats()
+    frames = 0
+    busy = 0
+
+    def end_frame():
+        nonlocal frame, frames, busy
+        if panel.modes and not opt.quiet:
+            print('frame %5d: %s' % (frames, ', '.join(panel.modes)))
+        panel.modes = []
+        if frame['bytes']:
+            if not opt.quiet:
+                print('frame %5d: %6d bytes %3d windows %6d pixels %6d redundant' %
+                      (frames, frame['bytes'], frame['windows'], frame['pixels'], frame['redundant']))
+            if opt.frames:
+                panel.save(os.path.join(opt.frames, 'frame%05d.ppm' % frames), view)
+            busy += 1
+        for k in total:
+            total[k] += frame[k]
+        frame = new_stats()
+        frames += 1
+
+    i = 0
+    while i < len(data):
+        b = data[i]
+        i += 1
+        if b == CAPTURE_FRAME:
+            end_frame()
+        elif b == CAPTURE_COMMAND:
+            if i >= len(data):
+                break
+            frame['bytes'] += 1
+            panel.command(data[i], frame)
+            i += 1
+        else:
+            if b == CAPTURE_ESCAPE:
+                if i >= len(data):
+                    break
+                b = data[i]
+                i += 1
+            frame['bytes'] += 1
+            panel.data(b, frame)
+    end_frame()
+
+    print('%d frames, %d drew something' % (frames, busy))
+    print('total: %d bytes, %d commands, %d windows, %d pixels, %d redundant (%.1f%%)' %
+          (total['bytes'], total['commands'], total['windows'], total['pixels'], total['redundant'],
+           100.0 * total['redundant'] / total['pixels'] if total['pixels'] else 0.0))
+
+    if opt.out:
+        panel.save(opt.out, view)
+    if opt.golden:
+        w, h, ref = read_ppm(opt.golden)
+        if (w, h) != (view[2], view[3]) or ref != panel.screen(view):
+            print('screen differs from ' + opt.golden)
+            return 1
+        print('screen matches ' + opt.golden)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())